@@ -76,8 +76,71 @@ public:
   static const char LBRACKET='[';
   static const char RBRACKET=']';
 
+  //the largest number of configurations of an action node's neighbourhood
+  //for which the payoffs and distributions are kept in dense tables
+  static const int MAX_DENSE_CONFIGS = 65536;
+  //the largest ratio of the number of configurations in a dense table to
+  //the number of payoffs, beyond which the trie is faster
+  static const int MAX_DENSE_RATIO = 32;
+
   friend class gametracer::aggame;   //wrapper class for gametracer
 
+  //Scratch space for computing expected payoffs and the payoff jacobian.
+  //Payoff computations do not modify the AGG itself, so several threads
+  //can compute payoffs on the same AGG at once, each with its own workspace.
+  class Workspace {
+  public:
+    Workspace(const AGG &g)
+      : numPlayers(g.numPlayers), projectedStrat(g.numActionNodes), Pr(g.numPlayers)
+    { }
+
+  private:
+    friend class AGG;
+    friend class gametracer::aggame;
+
+    int numPlayers;
+
+    //foreach s \in S, foreach i \in N, the projected mixed strat
+    //which is a prob distribution over the set of 'contributions'.
+    //The distributions for s are allocated when s is first projected.
+    std::vector<std::vector<aggdistrib> > projectedStrat;
+
+    //when computing the induced distribution via computeP():
+    //foreach k<= n-1,
+    //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
+
+    //when computing the partial distributions for the payoff jacobian:
+    //  foreach  j \in N,
+    // the partial distribution induced by all agents except j.
+    std::vector<aggdistrib> Pr;
+
+    //distributions over configurations for k-symmetric payoffs
+    aggdistrib d, temp;
+
+    //foreach j \in N, the distribution induced on the neighbourhood of
+    //an action node by all agents except j, as computed by computeNodeP(),
+    //and the prefix and suffix products used to compute them.
+    //These are allocated on first use.
+    std::vector<aggdistrib> nodeP, prefix, suffix;
+
+    //distributions over the configurations of a dense action node,
+    //and the scratch space to convolve them
+    AggNumberVector dense, denseScratch;
+
+    //foreach j \in N, the projected strat of j onto a dense action node,
+    //as the index and probability of each of j's contributions
+    std::vector<std::vector<std::pair<int,AggNumber> > > denseStrat;
+
+    //the tables of expected payoffs given the partial configurations
+    //used by getDensePayoffs()
+    std::vector<AggNumberVector> denseTables;
+
+    std::vector<aggdistrib> &getProjectedStrat(int Node) {
+      if (projectedStrat[Node].empty()) projectedStrat[Node].resize(numPlayers);
+      return projectedStrat[Node];
+    }
+  };
+
   //read an AGG from a file
   static AGG* makeAGG(char* filename);
 
@@ -98,7 +161,6 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
    std::vector<std::vector<std::vector<config> > >& proj,
    std::vector<std::vector<proj_func*> > & projF,
    std::vector<std::vector<std::vector<int> > >& Po,
-   std::vector<aggdistrib> &P,
       std::vector<aggpayoff>& payoffs);
 
 
@@ -121,22 +183,22 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   }
 
 
-  inline int getNumPlayers() {return numPlayers;}
-  inline int getNumActions() {return totalActions;}
-  inline int getNumActions(int i){return actions[i];}  
-  inline int getMaxActions() {return maxActions;}
-  inline int firstAction(int i) {return strategyOffset[i];}
-  inline int lastAction(int i) {return strategyOffset[i+1];}
+  inline int getNumPlayers() const {return numPlayers;}
+  inline int getNumActions() const {return totalActions;}
+  inline int getNumActions(int i) const {return actions[i];}
+  inline int getMaxActions() const {return maxActions;}
+  inline int firstAction(int i) const {return strategyOffset[i];}
+  inline int lastAction(int i) const {return strategyOffset[i+1];}
 
-  inline int getNumActionNodes() {return numActionNodes;}
-  inline int getNumFunctionNodes() {return numPNodes;}
+  inline int getNumActionNodes() const {return numActionNodes;}
+  inline int getNumFunctionNodes() const {return numPNodes;}
   //inline int getNumUniqueActionSets(){return uniqueActionSets.size();}
-  inline int getNumKSymActions(){return numKSymActions;}
-  inline int getNumKSymActions(int i){return uniqueActionSets[i].size();}
-  inline int getNumPlayerClasses(){return playerClasses.size();}
-  inline const PlayerSet& getPlayerClass(int cls){return playerClasses.at(cls);}
-  inline int firstKSymAction(int i){return kSymStrategyOffset[i];}
-  inline int lastKSymAction(int i){return kSymStrategyOffset[i+1];}
+  inline int getNumKSymActions() const {return numKSymActions;}
+  inline int getNumKSymActions(int i) const {return uniqueActionSets[i].size();}
+  inline int getNumPlayerClasses() const {return playerClasses.size();}
+  inline const PlayerSet& getPlayerClass(int cls) const {return playerClasses.at(cls);}
+  inline int firstKSymAction(int i) const {return kSymStrategyOffset[i];}
+  inline int lastKSymAction(int i) const {return kSymStrategyOffset[i+1];}
 
   inline void printActionGraph(std::ostream &s) {
     for(size_t i=0;i< neighbors.size(); ++i){
@@ -153,40 +215,78 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
   }
 
 
-  //exp. payoff under mixed strat profile
-  AggNumber getMixedPayoff(int player, StrategyProfile &s);
-  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s);
-  AggNumber getV (int player, int action,const StrategyProfile &s);
-  AggNumber getJ(int player,int action, int player2,int action2,StrategyProfile &s);
-
-
-  AggNumber getPurePayoff(int player, int *s);
+  //exp. payoff under mixed strat profile.
+  //Each of the payoff computations has a version using a
+  //caller-supplied workspace, and one which uses its own.
+  AggNumber getMixedPayoff(int player, const StrategyProfile &s, Workspace &w) const;
+  AggNumber getMixedPayoff(int player, const StrategyProfile &s) const
+    { Workspace w(*this); return getMixedPayoff(player, s, w); }
+  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s,
+                       Workspace &w) const;
+  void getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s) const
+    { Workspace w(*this); getPayoffVector(dest, player, s, w); }
+  AggNumber getV (int player, int action,const StrategyProfile &s, Workspace &w) const;
+  AggNumber getV (int player, int action,const StrategyProfile &s) const
+    { Workspace w(*this); return getV(player, action, s, w); }
+  AggNumber getJ(int player,int action, int player2,int action2,const StrategyProfile &s,
+                 Workspace &w) const;
+  //the payoff vectors of all players, indexed as the strategy profile.
+  //The distribution over each action node's neighbourhood is computed
+  //once for all the players who have that node in their action sets.
+  void getPayoffVectors(AggNumberVector &dest, const StrategyProfile &s, Workspace &w) const;
+  void getPayoffVectors(AggNumberVector &dest, const StrategyProfile &s) const
+    { Workspace w(*this); getPayoffVectors(dest, s, w); }
+  AggNumber getJ(int player,int action, int player2,int action2,const StrategyProfile &s) const
+    { Workspace w(*this); return getJ(player, action, player2, action2, s, w); }
+
+
+  AggNumber getPurePayoff(int player, int *s) const;
   inline void printPayoffs(std::ostream &s, int node){
     s << payoffs.at(node).size()<<std::endl;
     s << payoffs[node];
   }
 
-  bool isSymmetric(){
+  bool isSymmetric() const {
     for (int i=0;i<numPlayers;++i){
       if (actions[i]<numActionNodes) return false;
     }
     return true;
   }
-  AggNumber getSymMixedPayoff( StrategyProfile &s);
-  AggNumber getSymMixedPayoff(int actnode, StrategyProfile &s);
-  void getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s);
-  AggNumber getKSymMixedPayoff( int playerClass,std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff( int playerClass,StrategyProfile &s);
-  AggNumber getKSymMixedPayoff(int playerClass, int act, std::vector<StrategyProfile> &s);
-  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1);
-  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, StrategyProfile &s);
+  AggNumber getSymMixedPayoff(const StrategyProfile &s, Workspace &w) const;
+  AggNumber getSymMixedPayoff(const StrategyProfile &s) const
+    { Workspace w(*this); return getSymMixedPayoff(s, w); }
+  AggNumber getSymMixedPayoff(int actnode, const StrategyProfile &s, Workspace &w) const;
+  AggNumber getSymMixedPayoff(int actnode, const StrategyProfile &s) const
+    { Workspace w(*this); return getSymMixedPayoff(actnode, s, w); }
+  void getSymPayoffVector(AggNumberVector& dest, const StrategyProfile &s, Workspace &w) const;
+  void getSymPayoffVector(AggNumberVector& dest, const StrategyProfile &s) const
+    { Workspace w(*this); getSymPayoffVector(dest, s, w); }
+  AggNumber getKSymMixedPayoff(int playerClass, const std::vector<StrategyProfile> &s,
+                               Workspace &w) const;
+  AggNumber getKSymMixedPayoff(int playerClass, const std::vector<StrategyProfile> &s) const
+    { Workspace w(*this); return getKSymMixedPayoff(playerClass, s, w); }
+  AggNumber getKSymMixedPayoff(int playerClass, const StrategyProfile &s, Workspace &w) const;
+  AggNumber getKSymMixedPayoff(int playerClass, const StrategyProfile &s) const
+    { Workspace w(*this); return getKSymMixedPayoff(playerClass, s, w); }
+  AggNumber getKSymMixedPayoff(int playerClass, int act, const std::vector<StrategyProfile> &s,
+                               Workspace &w) const;
+  AggNumber getKSymMixedPayoff(int playerClass, int act, const std::vector<StrategyProfile> &s) const
+    { Workspace w(*this); return getKSymMixedPayoff(playerClass, act, s, w); }
+  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2,
+                               Workspace &w) const;
+  AggNumber getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2=-1,int act2=-1) const
+    { Workspace w(*this); return getKSymMixedPayoff(s, pClass1, act1, pClass2, act2, w); }
+  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, const StrategyProfile &s,
+                           Workspace &w) const;
+  void getKSymPayoffVector(AggNumberVector& dest, int playerClass, const StrategyProfile &s) const
+    { Workspace w(*this); getKSymPayoffVector(dest, playerClass, s, w); }
 
 
 
   //void KSymNormalizeStrategy(StrategyProfile &s);
 
 
-  AggNumberVector getExpectedConfig(StrategyProfile &s){
+  AggNumberVector getExpectedConfig(const StrategyProfile &s) const {
 	  AggNumberVector res(numActionNodes, 0);
 	  for (int i=0;i<numPlayers;++i){
 		  for(int j=0;j<actions[i];++j){
@@ -196,14 +296,14 @@ std::vector<projtype>& projTypes, int seed, bool int_payoffs=false, int int_fact
 	  return res;
   }
 
-  std::vector<proj_func*>& getProjFunctions(int node){return projFunctions.at(node);}
-  const std::vector<int>& getPorder(int player, int action){return Porder.at(player).at(action);}
-  const std::vector<std::vector<config> >& getProjection(int node){return projection.at(node);}
-  const std::vector<int>& getActionSet(int player){return actionSets.at(player);}
-  const aggpayoff& getPayoffMap(int node){return payoffs.at(node);}
+  const std::vector<proj_func*>& getProjFunctions(int node) const {return projFunctions.at(node);}
+  const std::vector<int>& getPorder(int player, int action) const {return Porder.at(player).at(action);}
+  const std::vector<std::vector<config> >& getProjection(int node) const {return projection.at(node);}
+  const std::vector<int>& getActionSet(int player) const {return actionSets.at(player);}
+  const aggpayoff& getPayoffMap(int node) const {return payoffs.at(node);}
 
-  AggNumber getMaxPayoff();
-  AggNumber getMinPayoff();
+  AggNumber getMaxPayoff() const;
+  AggNumber getMinPayoff() const;
 
 
 
@@ -244,10 +344,6 @@ private:
   // the contribution of s' to D^(s)
   //std::vector<std::vector<config> > projection;
 
-  //foreach s \in S, foreach i \in N, the projected mixed strat
-  //which is a prob distribution over the set of 'contributions'
-  std::vector< std::vector<aggdistrib > > projectedStrat;
-
   // foreach s in S, i in N, the full set of projected actions.
   std::vector<std::vector<aggdistrib> >fullProjectedStrat;
 
@@ -258,23 +354,27 @@ private:
   // in which we apply the DP algorithm
   std::vector< std::vector< std::vector<int> > > Porder;
 
-  //when computing the induced distribution via ComputeP():
-  //foreach k<= n-1,  
-  //prob. distrib P_k induced by the partial strat profile of agents o_1..o_k
-
-  //when computing the partial distributions for the payoff jacobian:
-  //  foreach  j \in N,
-  // the partial distribution induced by all agents except j. 
-  std::vector<aggdistrib>  Pr;
-
   //foreach s in S, whether s's neighbors are all action nodes
   std::vector<bool> isPure;
 
   //foreach s in S, j in N, the index of s in j's action set, or -1 if N/A
   std::vector<std::vector<int> > node2Action;
 
-  //cache of jacobian entries.
-  trie_map<AggNumber> cache;
+  //foreach s in S, whether the payoffs and distributions for s are kept
+  //in dense tables instead of tries.  This is done when each neighbor of s
+  //sums nonnegative contributions, and there are at most MAX_DENSE_CONFIGS
+  //configurations in the box bounding the partial configurations, and at
+  //most MAX_DENSE_RATIO times as many as there are payoffs.
+  //A configuration is then indexed in mixed radix, and the index of the
+  //sum of two configurations is the sum of their indices.
+  std::vector<bool> isDense;
+
+  //foreach s in S with isDense[s], the payoffs indexed by configuration
+  std::vector<AggNumberVector> densePayoffs;
+
+  //foreach s in S with isDense[s], foreach i in N, foreach s_i in S_i,
+  //the index of the contribution of s_i to D^(s)
+  std::vector<std::vector<std::vector<int> > > denseProjection;
 
   //the unique action sets
   std::vector<ActionSet> uniqueActionSets;
@@ -336,17 +436,34 @@ private:
 
 
   //private methods:
-  void computeP(int player, int act, int player2=-1,int act2=-1);
-  void doProjection(int Node,const StrategyProfile& s){
-	  doProjection (Node, &(const_cast<StrategyProfile &>(s)[0]));
+  void computeP(int player, int act, Workspace &w, int player2=-1,int act2=-1) const;
+  //foreach player j with Node in her action set, compute the distribution
+  //induced by all other agents on the neighbourhood of Node, in w.nodeP[j].
+  //The strategies must already be projected onto Node.
+  void computeNodeP(int Node, Workspace &w) const;
+  void doProjection(int Node,const StrategyProfile& s, Workspace &w) const {
+	  doProjection (Node, &s[0], w);
   }
-  void doProjection(int Node, int player, const StrategyProfile& s){
-	  doProjection(Node,player, &(const_cast<StrategyProfile &>(s)[firstAction(player)]));
+  void doProjection(int Node, int player, const StrategyProfile& s, Workspace &w) const {
+	  doProjection(Node,player, &s[firstAction(player)], w);
   }
-  void doProjection(int Node, AggNumber* s);
-  void doProjection(int Node, int player, AggNumber* s);
-
-  void getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2=-1,int act2=-1);
+  void doProjection(int Node, const AggNumber* s, Workspace &w) const;
+  void doProjection(int Node, int player, const AggNumber* s, Workspace &w) const;
+
+  //set up the dense tables of the action nodes with small neighbourhoods
+  void initDense();
+  //the projected strat of player i onto the dense action node Node, in w.denseStrat[i]
+  void doDenseProjection(int Node, int i, const AggNumber* s, Workspace &w) const;
+  //as getJ(), for a dense action node
+  AggNumber getDenseV(int player, int act, const StrategyProfile &s, Workspace &w,
+                      int player2=-1, int act2=-1) const;
+  //the payoffs to all the players with the dense action node Node in
+  //their action sets, stored in dest as in getPayoffVectors()
+  void getDensePayoffs(int Node, const StrategyProfile &s, AggNumberVector &dest,
+                       Workspace &w) const;
+
+  void getSymConfigProb(int plClass, const StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,
+                        Workspace &w, int plClass2=-1,int act2=-1) const;
 };
 
 }  // end namespace Gambit::agg
@@ -52,6 +52,23 @@ public:
 
   friend std::ostream& operator<< (std::ostream& s, const BAGG& g);
 
+  //Scratch space for computing expected payoffs, so that repeated
+  //computations need not allocate.  As for AGG::Workspace, each thread
+  //computing payoffs needs its own.
+  class Workspace {
+  public:
+    Workspace(const BAGG &g)
+      : aggStrat(g.aggPtr->getNumActions()), aggWorkspace(*g.aggPtr)
+    { }
+
+  private:
+    friend class BAGG;
+
+    //the mixed strat profile induced on the AGG
+    StrategyProfile aggStrat;
+    AGG::Workspace aggWorkspace;
+  };
+
   static BAGG* makeBAGG(char *filename);
   static BAGG* makeBAGG(std::istream &in);
   static BAGG* makeRandomBAGG(int n,std::vector<int> &numTypes,std::vector<ProbDist> &TDist,int S,int P,
@@ -91,13 +108,23 @@ public:
 	  return aggPtr->getMinPayoff();
   }
 
-  //exp. payoff under mixed strat profile
-  AggNumber getMixedPayoff(int player, StrategyProfile &s);
+  //exp. payoff under mixed strat profile.
+  //Each of these has a version using a caller-supplied workspace.
+  AggNumber getMixedPayoff(int player, StrategyProfile &s)
+    { Workspace w(*this); return getMixedPayoff(player, s, w); }
+  AggNumber getMixedPayoff(int player, const StrategyProfile &s, Workspace &w);
   //exp payoff for player, conditioned on her receiving type tp.
-  AggNumber getMixedPayoff(int player,int tp, StrategyProfile &s);
-
-  void getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s);
-  AggNumber getV (int player, int tp, int action,const StrategyProfile &s);
+  AggNumber getMixedPayoff(int player,int tp, StrategyProfile &s)
+    { Workspace w(*this); return getMixedPayoff(player, tp, s, w); }
+  AggNumber getMixedPayoff(int player,int tp, const StrategyProfile &s, Workspace &w);
+
+  void getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s)
+    { Workspace w(*this); getPayoffVector(dest, player, tp, s, w); }
+  void getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s,
+                       Workspace &w);
+  AggNumber getV (int player, int tp, int action,const StrategyProfile &s)
+    { Workspace w(*this); return getV(player, tp, action, s, w); }
+  AggNumber getV (int player, int tp, int action,const StrategyProfile &s, Workspace &w);
 
   AggNumber getPurePayoff(int player, int tp, int *s);
   AggNumber getPurePayoff(int player, int *s){
@@ -192,10 +192,10 @@ public:
 
   //polynomial multiplication of t1 and t2, store the result in self
   void multiply (const trie_map<V>& t1,const trie_map<V>& t2,size_t keylen,
-	 std::vector<proj_func*>& f)
+	 const std::vector<proj_func*>& f)
   {
-    static size_t i;
-    static std::pair<std::vector<int>, V> v;
+    size_t i;
+    std::pair<std::vector<int>, V> v;
     const_iterator p1,p2;
     //assert(this!=&t1 && this != &t2);
     v.first.resize(keylen);
@@ -217,9 +217,9 @@ public:
   //Do simplification when V is a class of symbolic expressions and there is strict independence
   //However, wouldn't it be sufficient to check if projectedStrat is a singleton?
   void multiply_smart (const trie_map<V>& P_k_minus_1,const trie_map<V>& projectedStrat,size_t keylen,
-                        std::vector<proj_func*>& f)
+                        const std::vector<proj_func*>& f)
         {
-                static std::pair<std::vector<int>, V> v;
+                std::pair<std::vector<int>, V> v;
                 v.first.resize(keylen);
                 reset();
 
@@ -270,11 +270,11 @@ public:
         }
 
   //multiply in-place. other should not be the same object as self.
-  void multiply (const trie_map<V>& other,size_t keylen, std::vector<proj_func*>& f);
+  void multiply (const trie_map<V>& other,size_t keylen, const std::vector<proj_func*>& f);
 
   //squaring
-  void square(trie_map<V>& dest, size_t keylen, std::vector<proj_func*>& f) const{
-    static std::pair<std::vector<int>, V> v;
+  void square(trie_map<V>& dest, size_t keylen, const std::vector<proj_func*>& f) const{
+    std::pair<std::vector<int>, V> v;
     v.first.resize(keylen);
     //assert(this!=&dest);
     dest.reset();
@@ -292,9 +292,9 @@ public:
   }
 
   //squaring in-place
-  void square(size_t keylen, std::vector<proj_func*>& f){
-    static typename std::list<typename trie_map<V>::value_type>::iterator p1,p2;
-    static std::pair<std::vector<int>, V> v;
+  void square(size_t keylen, const std::vector<proj_func*>& f){
+    typename std::list<typename trie_map<V>::value_type>::iterator p1,p2;
+    std::pair<std::vector<int>, V> v;
     v.first.resize(keylen);
     std::list<typename trie_map<V>::value_type> data2;
     //data.swap(data2);
@@ -316,7 +316,7 @@ public:
   //take power of self using repeated squaring. result stored in dest.
   //this is actually slower than power by straight multiplication, if the # of configurations grow polynomially
   //in the # of players.
-  void power_repsq (size_t p, trie_map<V>& dest, size_t keylen, std::vector<proj_func*>& f) const{
+  void power_repsq (size_t p, trie_map<V>& dest, size_t keylen, const std::vector<proj_func*>& f) const{
     //assert(p>0 && this!=&dest );
     if(p==1){
       dest=*this;
@@ -338,7 +338,7 @@ public:
     }
   }
 
-  void power(size_t p, trie_map<V> &dest,trie_map<V> &scratch, size_t keylen, std::vector<proj_func*> &f){
+  void power(size_t p, trie_map<V> &dest,trie_map<V> &scratch, size_t keylen, const std::vector<proj_func*> &f) const {
     //assert(p>0 && this!=&dest );
     if (p==1) {
       dest = *this;
@@ -359,7 +359,7 @@ public:
   }
 
   //inner product
-  V inner_prod( trie_map<V>& other, V init= (V)(0) ) const{
+  V inner_prod(const trie_map<V>& other, V init= (V)(0) ) const{
     V result(init);
     //V th(THRESH);
     for(const_iterator p=begin(); p!=end(); ++p)if((*p).second>(V)0){
@@ -380,12 +380,12 @@ public:
   }
 
   //first apply the action x, then inner prod
-  V inner_prod(const std::vector<int>& x, size_t keylen, std::vector<proj_func*>& f,
-	trie_map<V>& other, V init=(V)(0) ) const
+  V inner_prod(const std::vector<int>& x, size_t keylen, const std::vector<proj_func*>& f,
+	const trie_map<V>& other, V init=(V)(0) ) const
   { 
     V result(init);
     V th(THRESH);
-    static iterator p2;
+    iterator p2;
     //V s(-1);
     for (const_iterator p=begin(); p!=end();++p)if((*p).second>(V)0){
       value_type y= *p;
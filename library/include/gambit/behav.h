@@ -27,6 +27,8 @@
 
 namespace Gambit {
 
+class GameTreeLayout;
+
 ///
 /// MixedBehaviorProfile<T> implements a randomized behavior profile on
 /// an extensive game.
@@ -48,6 +50,13 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_gripe;
 
+  // structures for evaluating over the flattened tree: the realization
+  // probabilities of information sets, and the index in the profile of
+  // each action, or zero if it is not in the support, numbered as in
+  // GameTreeLayout
+  mutable Array<T> m_infosetProbs;
+  mutable Array<int> m_profileIndex;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -61,8 +70,10 @@ protected:
   //@{
   void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
   
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  /// Returns the probability of the action leading to the node
+  T GetPriorActionProb(const GameTreeLayout &, int node) const;
+  void ComputeSolutionDataPass2(const GameTreeLayout &) const;
+  void ComputeSolutionDataPass1(const GameTreeLayout &) const;
   void ComputeSolutionData(void) const;
   //@}
 
@@ -25,6 +25,7 @@
 #define LIBGAMBIT_GAME_H
 
 #include <memory>
+#include <atomic>
 #include "dvector.h"
 #include "number.h"
 
@@ -38,10 +39,11 @@ namespace Gambit {
 /// with a positive reference count will not have its memory deleted,
 /// but will instead be marked as deleted.  Calling code should always
 /// be careful to check the deleted status of the object before any
-/// operations on it.
+/// operations on it.  The reference count is maintained atomically, so
+/// that handles to the same object may be held by several threads.
 class GameObject {
 protected:
-  int m_refCount;
+  std::atomic<int> m_refCount;
   bool m_valid;
 
 public:
@@ -236,11 +238,9 @@ public:
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
+  /// Sets the payoff to player 'pl'
+  void SetPayoff(int pl, const Number &p_value);
 
   /// Map the outcome to the corresponding outcome in the unrestricted game
   GameOutcome Unrestrict(void) const 
@@ -648,6 +648,7 @@ public:
 
 /// This is the class for representing an arbitrary finite game.
 class GameRep : public GameObject {
+  friend class GameOutcomeRep;
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
@@ -672,6 +673,8 @@ protected:
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return false; }
+  /// Clear out any values cached from outcome payoffs
+  virtual void ClearComputedPayoffs(void) const { }
   //@}
 
 
@@ -691,6 +694,8 @@ public:
 
   /// Returns true if the game has a action-graph game representation
   virtual bool IsAgg(void) const { return false; }
+  /// Returns true if the game has a Bayesian action-graph game representation
+  virtual bool IsBagg(void) const { return false; }
 
   /// Returns true if the game is a restriction of a more general game
   virtual bool IsRestriction(void) const { return false; }
@@ -816,6 +821,17 @@ Game NewTable(const Array<int> &p_dim, bool p_sparseOutcomes = false);
 // all classes to be defined.
 
 inline Game GameOutcomeRep::GetGame(void) const { return m_game; }
+inline void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearComputedPayoffs();
+}
+
+inline void GameOutcomeRep::SetPayoff(int pl, const Number &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearComputedPayoffs();
+}
 
 inline GamePlayer GameStrategyRep::GetPlayer(void) const { return m_player; }
 
@@ -841,6 +857,16 @@ template<> inline std::string PureBehaviorProfile::GetPayoff(int pl) const
 
 /// Reads a game in .efg or .nfg format from the input stream
 Game ReadGame(std::istream &) throw (InvalidFileException);
+/// Reads a game in .efg or .nfg format from the named file.  The file
+/// is memory-mapped where the platform supports it.
+Game ReadGameFile(const std::string &) throw (InvalidFileException);
+/// Returns true if the characters in [p_begin, p_end) begin a game
+/// in binary format
+bool IsBinaryGame(const char *p_begin, const char *p_end);
+/// Reads a game in binary format from the characters in [p_begin, p_end),
+/// which should be aligned to an eight-byte boundary
+Game ReadBinaryGame(const char *p_begin, const char *p_end)
+  throw (InvalidFileException);
 
 } // end namespace gambit
 
@@ -41,6 +41,8 @@ protected:
   /// Write the game in .nfg format to the specified stream
   virtual void WriteNfgFile(std::ostream &) const
   { throw UndefinedException(); }
+  /// Write the game in binary format to the specified stream
+  void WriteBinaryFile(std::ostream &) const;
   //@}
 
 public:
@@ -23,6 +23,7 @@
 #ifndef GAMETABLE_H
 #define GAMETABLE_H
 
+#include <mutex>
 #include "gameexpl.h"
 
 namespace Gambit {
@@ -37,11 +38,30 @@ class GameTableRep : public GameExplicitRep {
 private:
   Array<GameOutcomeRep *> m_results;
   Game m_unrestricted;
+  /// Dense tables of payoffs for each player, indexed in parallel with
+  /// m_results; these are built on demand, and are empty when not current
+  mutable Array<Array<double> > m_doublePayoffs;
+  mutable Array<Array<Rational> > m_rationalPayoffs;
+  /// Flags whether each of the tables is current.  The tables are built
+  /// holding the mutex, so that several threads may evaluate profiles
+  /// on the game at once.
+  mutable std::atomic<bool> m_hasDoublePayoffs, m_hasRationalPayoffs;
+  mutable std::mutex m_payoffsMutex;
 
   /// @name Private auxiliary functions
   //@{
   void IndexStrategies(void);
   void RebuildTable(void);
+  template <class T> void BuildPayoffTable(Array<Array<T> > &) const;
+  //@}
+
+protected:
+  /// @name Managing the representation
+  //@{
+  /// Clear out any computed values
+  virtual void ClearComputedValues(void) const;
+  /// Clear out the dense payoff tables
+  virtual void ClearComputedPayoffs(void) const;
   //@}
 
 public:
@@ -116,6 +136,21 @@ public:
   virtual void DeleteOutcome(const GameOutcome &);
   //@}
 
+  /// @name Dense payoff tables
+  //@{
+  /// \brief Returns the table of payoffs to player pl
+  ///
+  /// Returns the payoffs to player pl for each contingency, as a
+  /// array indexed in the same way as the outcome table (that is,
+  /// one plus the sum of the offsets of the strategies in the
+  /// contingency).  Contingencies with no outcome have payoff zero.
+  /// The table is built on first use, and is discarded whenever an
+  /// outcome or the assignment of outcomes to contingencies changes.
+  const Array<double> &GetPayoffTable(int pl, double) const;
+  /// Returns the table of payoffs to player pl, in exact arithmetic
+  const Array<Rational> &GetPayoffTable(int pl, const Rational &) const;
+  //@}
+
   /// @name Writing data files
   //@{
   /// Write the game to a file in .nfg outcome format
@@ -23,6 +23,7 @@
 #ifndef GAMETREE_H
 #define GAMETREE_H
 
+#include <mutex>
 #include "gameexpl.h"
 
 namespace Gambit {
@@ -195,19 +196,157 @@ public:
   virtual GameInfoset InsertMove(GameInfoset p_infoset);
 };
 
+///
+/// An immutable, flattened form of the tree of a game, for evaluating
+/// profiles by sweeping over arrays instead of walking the node objects.
+/// Arrays over nodes are indexed by node number.  Information sets are
+/// numbered across all players, starting with those of the chance
+/// player; actions are numbered across the personal players, in the
+/// same order as the entries of a DVector over GameRep::NumActions().
+///
+class GameTreeLayout {
+  friend class GameTreeRep;
+
+private:
+  Array<int> m_preorder, m_postorder;
+  Array<int> m_parent, m_action, m_actionIndex;
+  Array<int> m_infoset, m_player, m_outcome;
+  Array<int> m_firstChild, m_numChildren, m_children;
+  Array<int> m_firstInfoset, m_firstMember, m_numMembers, m_members;
+  Array<double> m_doubleProbs;
+  Array<Rational> m_rationalProbs;
+  Matrix<double> m_doublePayoffs;
+  Matrix<Rational> m_rationalPayoffs;
+  int m_numActions;
+
+public:
+  GameTreeLayout(void) : m_numActions(0) { }
+
+  /// @name Nodes
+  //@{
+  int NumNodes(void) const { return m_parent.Length(); }
+  /// The nodes in preorder, so that each node follows its parent
+  const Array<int> &Preorder(void) const { return m_preorder; }
+  /// The nodes in postorder, so that each node follows its children
+  const Array<int> &Postorder(void) const { return m_postorder; }
+  /// The parent of the node, or zero at the root
+  int GetParent(int p_node) const { return m_parent[p_node]; }
+  /// The number at its parent of the action leading to the node
+  int GetAction(int p_node) const { return m_action[p_node]; }
+  /// The index of the action leading to the node, or zero if the
+  /// parent belongs to the chance player or the node is the root
+  int GetActionIndex(int p_node) const { return m_actionIndex[p_node]; }
+  /// The information set at the node, or zero at terminal nodes
+  int GetInfoset(int p_node) const { return m_infoset[p_node]; }
+  /// The number of the player who has the move at the node, which is
+  /// zero for the chance player and at terminal nodes
+  int GetPlayer(int p_node) const { return m_player[p_node]; }
+  /// The number of the outcome at the node, or zero if there is none
+  int GetOutcome(int p_node) const { return m_outcome[p_node]; }
+  int NumChildren(int p_node) const { return m_numChildren[p_node]; }
+  int GetChild(int p_node, int p_index) const
+  { return m_children[m_firstChild[p_node] + p_index - 1]; }
+  /// The probability of the chance action leading to the node, if
+  /// the parent belongs to the chance player
+  template <class T> const T &GetChanceProb(int p_node) const;
+  //@}
+
+  /// @name Information sets and actions
+  //@{
+  int NumInfosets(void) const { return m_numMembers.Length(); }
+  /// The index of the p_iset'th information set of player p_player
+  int GetInfosetIndex(int p_player, int p_iset) const
+  { return m_firstInfoset[p_player] + p_iset; }
+  int NumMembers(int p_infoset) const { return m_numMembers[p_infoset]; }
+  int GetMember(int p_infoset, int p_index) const
+  { return m_members[m_firstMember[p_infoset] + p_index - 1]; }
+  int NumActions(void) const { return m_numActions; }
+  //@}
+
+  /// @name Outcomes
+  //@{
+  /// The payoffs of the outcomes, with a row for each outcome and a
+  /// column for each player
+  template <class T> const Matrix<T> &GetPayoffs(void) const;
+  //@}
+};
+
+template<> inline const double &
+GameTreeLayout::GetChanceProb<double>(int p_node) const
+{ return m_doubleProbs[p_node]; }
+template<> inline const Rational &
+GameTreeLayout::GetChanceProb<Rational>(int p_node) const
+{ return m_rationalProbs[p_node]; }
+template<> inline const Matrix<double> &
+GameTreeLayout::GetPayoffs<double>(void) const
+{ return m_doublePayoffs; }
+template<> inline const Matrix<Rational> &
+GameTreeLayout::GetPayoffs<Rational>(void) const
+{ return m_rationalPayoffs; }
+
 
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
   friend class GameTreeActionRep;
 protected:
-  mutable bool m_computedValues, m_doCanon;
+  /// Flags whether the computed values are current; these are built
+  /// holding the mutex, so that several threads may use the game at once
+  mutable std::atomic<bool> m_computedValues;
+  mutable bool m_doCanon;
+  mutable std::mutex m_computedMutex;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
+  /// The flattened form of the tree, if m_hasLayout is set; it is built
+  /// along with the computed values, or on its own when asked for
+  mutable std::atomic<bool> m_hasLayout;
+  mutable GameTreeLayout m_layout;
+  /// The number of contingencies of the reduced strategic form, counted
+  /// along with the strategies, or zero if there are too many to count
+  long m_numContingencies;
+  /// The largest number of contingencies for which the payoffs of the
+  /// reduced strategic form are tabulated
+  mutable long m_maxPayoffTable;
+  /// Dense tables of the payoffs of the reduced strategic form, indexed
+  /// as those of a table game; these are built on demand, holding the
+  /// mutex, and are empty when not current
+  mutable Array<Array<double> > m_doublePayoffs;
+  mutable Array<Array<Rational> > m_rationalPayoffs;
+  mutable std::atomic<bool> m_hasDoublePayoffs, m_hasRationalPayoffs;
+  /// Whether the game has perfect recall, if m_hasRecall is set, and if
+  /// not a pair of information sets at which recall fails; these are
+  /// found with the computed values, holding the mutex
+  mutable std::atomic<bool> m_hasRecall;
+  mutable bool m_perfectRecall;
+  mutable GameTreeInfosetRep *m_recallInfoset1, *m_recallInfoset2;
+  /// The depth of the open transactions, and whether an edit made in
+  /// them has deferred canonicalization to the end of the outermost
+  int m_transactionDepth;
+  bool m_deferredCanon;
 
   /// @name Private auxiliary functions
   //@{
   void NumberNodes(GameTreeNodeRep *, int &);
+  /// Builds the flattened form of the tree; the mutex must be held
+  void BuildLayout(void) const;
+  /// Builds a new game from the subtree rooted at the node
+  Game CopySubgame(const GameTreeNodeRep *) const;
+  /// Checks for perfect recall, recording the result
+  void BuildPerfectRecall(void) const;
+  /// Checks the recall at the nodes of the subtree rooted at the node,
+  /// given the last action of each player on the path to it
+  bool CheckPerfectRecall(const GameTreeNodeRep *,
+			  Array<GameTreeActionRep *> &p_lastActions,
+			  Array<Array<GameTreeActionRep *> > &p_infosetActions,
+			  Array<Array<bool> > &p_visited) const;
+  /// Builds the tables of payoffs of the reduced strategic form
+  template <class T> void BuildPayoffTable(Array<Array<T> > &) const;
+  /// Sets p_payoffs to the payoffs to each player of the subtree rooted
+  /// at the node, when the players play the strategies in the profile
+  template <class T> 
+  void GetPayoffs(const GameTreeNodeRep *,
+		  const Array<GameStrategyRep *> &p_profile,
+		  Array<T> &p_payoffs) const;
   //@}
 
   /// @name Managing the representation
@@ -215,6 +354,7 @@ protected:
   virtual void Canonicalize(void);
   virtual void BuildComputedValues(void);
   virtual void ClearComputedValues(void) const;
+  virtual void ClearComputedPayoffs(void) const;
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return m_computedValues; }
   //@}
@@ -239,6 +379,23 @@ public:
     if (m_doCanon) const_cast<GameTreeRep *>(this)->Canonicalize(); }
   //@}
 
+  /// @name Transactions
+  //@{
+  /// \brief Begins a transaction, a batch of edits to the tree
+  ///
+  /// Until the transaction is committed, edits do not renumber the nodes
+  /// or reorder the members and information sets; the game is put in
+  /// canonical form once, when the outermost of any nested transactions
+  /// is committed.  In the meantime, the numbers of the nodes are not
+  /// current, and strategies and profiles should not be used.  Edits
+  /// are not undone if a transaction is never committed.
+  void BeginTransaction(void) { m_transactionDepth++; }
+  /// Commits the innermost open transaction
+  void CommitTransaction(void);
+  /// Returns whether a transaction is open
+  bool InTransaction(void) const { return (m_transactionDepth > 0); }
+  //@}
+
   /// @name Players
   //@{
   /// Returns the chance (nature) player
@@ -253,10 +410,38 @@ public:
   virtual GameNode GetRoot(void) const { return m_root; } 
   /// Returns the number of nodes in the game
   int NumNodes(void) const;
+  /// Returns the flattened form of the tree, building it if needed.
+  /// It stays valid until the game is next changed.
+  const GameTreeLayout &GetLayout(void) const;
   //@}
 
   virtual void DeleteOutcome(const GameOutcome &);
 
+  /// @name The reduced strategic form
+  //@{
+  /// A limit for SetPayoffTableLimit() which keeps the tables of
+  /// games with a few players to some tens of megabytes
+  static const long DEFAULT_PAYOFF_TABLE_LIMIT = 1L << 18;
+  /// \brief Sets the largest reduced strategic form to tabulate
+  ///
+  /// When the reduced strategic form has at most p_maxContingencies
+  /// contingencies, pure and mixed strategy profiles read their payoffs
+  /// from tables of it, built on first use, instead of walking the
+  /// tree.  The tables are discarded whenever the game changes.  By
+  /// default the limit is zero, and no tables are built.
+  void SetPayoffTableLimit(long p_maxContingencies) const
+  { m_maxPayoffTable = p_maxContingencies; }
+  /// Returns whether strategy profiles read payoffs from tables
+  bool HasPayoffTable(void) const
+  { return (m_computedValues && m_numContingencies > 0 &&
+	    m_numContingencies <= m_maxPayoffTable); }
+  /// Returns the table of payoffs to player pl in the reduced strategic
+  /// form, indexed as GameTableRep::GetPayoffTable()
+  const Array<double> &GetPayoffTable(int pl, double) const;
+  /// Returns the table of payoffs to player pl, in exact arithmetic
+  const Array<Rational> &GetPayoffTable(int pl, const Rational &) const;
+  //@}
+
   /// @name Writing data files
   //@{
   virtual void WriteEfgFile(std::ostream &) const;
@@ -95,6 +95,13 @@ class aggame : public gnmgame {
       aggPtr->getPayoffVector(d,player,sp);
       std::copy(d.begin(),d.end(), dest.values());
     }
+    void getPayoffVectors(cvector &dest, const cvector &s){
+      cvector & ss = const_cast<cvector &>(s);
+      std::vector<double> sp (ss.values(), ss.values()+ss.getm());
+      std::vector<double> d(aggPtr->getNumActions());
+      aggPtr->getPayoffVectors(d,sp);
+      std::copy(d.begin(),d.end(), dest.values());
+    }
     void getSymPayoffVector(cvector& dest, cvector &s){
       std::vector<double> sp (s.values(), s.values()+s.getm());
       std::vector<double> d(aggPtr->getNumActionNodes());
@@ -141,13 +148,17 @@ class aggame : public gnmgame {
   private:
 
   //helper functions for computing jacobian
-    void computePartialP_PureNode(int player,int act,std::vector<int>& tasks);
-    void computePartialP_bisect(int player,int act, std::vector<int>::iterator f,std::vector<int>::iterator l,Gambit::agg::aggdistrib& temp);
+    void computePartialP_PureNode(int player,int act,std::vector<int>& tasks,
+                                  Gambit::agg::AGG::Workspace &w, bool useNodeP);
+    void computePartialP_bisect(int player,int act, std::vector<int>::iterator f,std::vector<int>::iterator l,Gambit::agg::aggdistrib& temp,
+                                Gambit::agg::AGG::Workspace &w);
     void computePartialP(int player1, int act1, std::vector<int>& tasks,std::vector<int>& nontasks);
-    void computePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,Gambit::agg::trie_map<Gambit::agg::AggNumber>& cache);
+    void computePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,Gambit::agg::trie_map<Gambit::agg::AggNumber>& cache,
+                       Gambit::agg::AGG::Workspace &w);
     void savePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,Gambit::agg::AggNumber result,
 		    Gambit::agg::trie_map<Gambit::agg::AggNumber>& cache, bool partial=false );
-    void computeUndisturbedPayoff(Gambit::agg::AggNumber& undisturbedPayoff,bool& has,int player1,int act1,int player2);
+    void computeUndisturbedPayoff(Gambit::agg::AggNumber& undisturbedPayoff,bool& has,int player1,int act1,int player2,
+                                  Gambit::agg::AGG::Workspace &w);
 
 };
 
@@ -95,6 +95,15 @@ class gnmgame {
   // the owner of action i if he deviates from s by choosing i instead.
   virtual void getPayoffVector(cvector &dest, int player,const cvector &s) = 0; 
 
+  // store in dest the payoff vectors of all players, indexed as s.
+  virtual void getPayoffVectors(cvector &dest, const cvector &s){
+    for (int n=0;n<numPlayers;n++){
+      cvector payoffs(actions[n]);
+      getPayoffVector(payoffs, n, s);
+      for (int i=0;i<actions[n];i++) dest[firstAction(n)+i]=payoffs[i];
+    }
+  }
+
   //get payoff vector for a symmetric game under a symmetric strategy. only one player's strategy is given in s
   virtual void getSymPayoffVector(cvector &dest, cvector &s){
     cvector fulls(getNumActions());
@@ -126,8 +135,16 @@ class gnmgame {
   //return the max regret under strategy profile s
   double getRegret(cvector &s)
   {
-    cvector regrets(numPlayers);
-    for (int i=0;i<numPlayers;i++) regrets[i]= getRegret(i,s);
+    cvector payoffs(getNumActions()), regrets(numPlayers);
+    getPayoffVectors(payoffs, s);
+    for (int n=0;n<numPlayers;n++){
+      double p=0, best=payoffs[firstAction(n)];
+      for (int i=firstAction(n);i<lastAction(n);i++){
+	p+=payoffs[i] * s[i];
+	if (payoffs[i]>best) best=payoffs[i];
+      }
+      regrets[n]=best-p;
+    }
     return regrets.max();
   }
 
@@ -29,6 +29,11 @@ Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
 #define LIBGAMBIT_INTEGER_H
 
 #include <string>
+#include <climits>
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#define GAMBIT_INTEGER_OVERFLOW_BUILTINS
+#endif
 
 namespace Gambit {
 
@@ -83,22 +88,51 @@ extern int      Iisdouble(const IntegerRep*);
 extern long     lg(const IntegerRep*);
 
 class Integer {
+  friend class IntegerRepOf;
+
 protected:
+  /// The arbitrary-precision representation of the value, or null
+  /// if the value fits in a long, in which case it is held in val.
+  /// Values which fit in a long are always held in val.
   IntegerRep *rep;
+  long val;
+
+  /// Takes ownership of the representation, and stores it in val
+  /// instead if the value fits in a long
+  void Assign(IntegerRep *);
+  /// Stores the value in val, releasing any representation
+  void Assign(long p_value)
+  { if (rep) Release(); val = p_value; }
+  /// Releases the arbitrary-precision representation
+  void Release(void);
+
+  /// @name Arbitrary-precision versions of the inlined operations
+  //@{
+  static void AddRep(const Integer &x, const Integer &y, int negatey, Integer &dest);
+  static void MulRep(const Integer &x, const Integer &y, Integer &dest);
+  static int CompareRep(const Integer &x, const Integer &y);
+  static int CompareRep(const Integer &x, long y);
+  double AsDoubleRep(void) const;
+  //@}
 
 public:
   /// @name Lifecycle
   //@{
-  Integer(void);
-  Integer(int);
-  Integer(long);
+  Integer(void) : rep(0), val(0) { }
+  Integer(int y) : rep(0), val(y) { }
+  Integer(long y) : rep(0), val(y) { }
   Integer(unsigned long);
   Integer(IntegerRep *);
-  Integer(const Integer &);
-  ~Integer();
-
-  Integer &operator=(const Integer &);
-  Integer &operator=(long);
+  Integer(const Integer &y) : rep((y.rep) ? Icopy(0, y.rep) : 0), val(y.val) { }
+  ~Integer() { if (rep) Release(); }
+
+  Integer &operator=(const Integer &y)
+  {
+    if (!y.rep) Assign(y.val);
+    else if (this != &y) rep = Icopy(rep, y.rep);
+    return *this;
+  }
+  Integer &operator=(long y)  { Assign(y); return *this; }
   //@}
 
 
@@ -112,33 +146,33 @@ public:
 
   /// @name Comparison operators
   //@{
-  bool operator==(const Integer &) const;
-  bool operator==(long) const;
-  bool operator!=(const Integer &) const;
-  bool operator!=(long) const;
-  bool operator< (const Integer &) const;
-  bool operator< (long) const;
-  bool operator<=(const Integer &) const;
-  bool operator<=(long) const;
-  bool operator> (const Integer &) const;
-  bool operator> (long) const;
-  bool operator>=(const Integer &) const;
-  bool operator>=(long) const;
+  bool operator==(const Integer &y) const { return compare(*this, y) == 0; }
+  bool operator==(long y) const { return compare(*this, y) == 0; }
+  bool operator!=(const Integer &y) const { return compare(*this, y) != 0; }
+  bool operator!=(long y) const { return compare(*this, y) != 0; }
+  bool operator< (const Integer &y) const { return compare(*this, y) < 0; }
+  bool operator< (long y) const { return compare(*this, y) < 0; }
+  bool operator<=(const Integer &y) const { return compare(*this, y) <= 0; }
+  bool operator<=(long y) const { return compare(*this, y) <= 0; }
+  bool operator> (const Integer &y) const { return compare(*this, y) > 0; }
+  bool operator> (long y) const { return compare(*this, y) > 0; }
+  bool operator>=(const Integer &y) const { return compare(*this, y) >= 0; }
+  bool operator>=(long y) const { return compare(*this, y) >= 0; }
   //@}
 
   /// @name Assignment-based operations
   //@{
-  Integer &operator+=(const Integer &);
-  Integer &operator-=(const Integer &);
-  Integer &operator*=(const Integer &);
+  Integer &operator+=(const Integer &y) { add(*this, y, *this); return *this; }
+  Integer &operator-=(const Integer &y) { sub(*this, y, *this); return *this; }
+  Integer &operator*=(const Integer &y) { mul(*this, y, *this); return *this; }
   Integer &operator/=(const Integer &);
   Integer &operator%=(const Integer &);
   Integer &operator<<=(const Integer &);
   Integer &operator>>=(const Integer &);
 
-  Integer &operator+=(long);
-  Integer &operator-=(long);
-  Integer &operator*=(long);
+  Integer &operator+=(long y) { add(*this, y, *this); return *this; }
+  Integer &operator-=(long y) { sub(*this, y, *this); return *this; }
+  Integer &operator*=(long y) { mul(*this, y, *this); return *this; }
   Integer &operator/=(long);
   Integer &operator%=(long);
   Integer &operator<<=(long);
@@ -148,12 +182,18 @@ public:
   /// @name Operator overloading
   //@{
   Integer operator-(void) const;
-  Integer operator+(const Integer &) const;
-  Integer operator+(long) const;
-  Integer operator-(const Integer &) const;
-  Integer operator-(long) const;
-  Integer operator*(const Integer &) const;
-  Integer operator*(long) const;
+  Integer operator+(const Integer &y) const
+  { Integer r; add(*this, y, r); return r; }
+  Integer operator+(long y) const
+  { Integer r; add(*this, y, r); return r; }
+  Integer operator-(const Integer &y) const
+  { Integer r; sub(*this, y, r); return r; }
+  Integer operator-(long y) const
+  { Integer r; sub(*this, y, r); return r; }
+  Integer operator*(const Integer &y) const
+  { Integer r; mul(*this, y, r); return r; }
+  Integer operator*(long y) const
+  { Integer r; mul(*this, y, r); return r; }
   Integer operator/(const Integer &) const;
   Integer operator/(long) const;
   Integer operator%(const Integer &) const;
@@ -173,7 +213,8 @@ public:
   friend Integer  gcd(const Integer&, const Integer&);
   friend int      even(const Integer&); // true if even
   friend int      odd(const Integer&); // true if odd
-  friend int      sign(const Integer&); // returns -1, 0, +1
+  friend int      sign(const Integer& x) // returns -1, 0, +1
+  { return (x.rep) ? ((x.rep->sgn == 1) ? 1 : -1) : (x.val > 0) - (x.val < 0); }
 
   friend void     setbit(Integer& x, long b);   // set b'th bit of x
   friend void     clearbit(Integer& x, long b); // clear b'th bit
@@ -185,11 +226,30 @@ public:
   friend void     negate(const Integer& x, Integer& dest);
   friend void     complement(const Integer& x, Integer& dest);
 
-  friend int      compare(const Integer&, const Integer&);  
+  friend int      compare(const Integer &x, const Integer &y)
+  {
+    if (x.rep || y.rep) return CompareRep(x, y);
+    return (x.val > y.val) - (x.val < y.val);
+  }
   friend int      ucompare(const Integer&, const Integer&); 
-  friend void     add(const Integer& x, const Integer& y, Integer& dest);
-  friend void     sub(const Integer& x, const Integer& y, Integer& dest);
-  friend void     mul(const Integer& x, const Integer& y, Integer& dest);
+  friend void     add(const Integer& x, const Integer& y, Integer& dest)
+  {
+    long r;
+    if (x.rep || y.rep || !AddLong(x.val, y.val, r)) AddRep(x, y, 0, dest);
+    else dest.Assign(r);
+  }
+  friend void     sub(const Integer& x, const Integer& y, Integer& dest)
+  {
+    long r;
+    if (x.rep || y.rep || !SubLong(x.val, y.val, r)) AddRep(x, y, 1, dest);
+    else dest.Assign(r);
+  }
+  friend void     mul(const Integer& x, const Integer& y, Integer& dest)
+  {
+    long r;
+    if (x.rep || y.rep || !MulLong(x.val, y.val, r)) MulRep(x, y, dest);
+    else dest.Assign(r);
+  }
   friend void     div(const Integer& x, const Integer& y, Integer& dest);
   friend void     mod(const Integer& x, const Integer& y, Integer& dest);
   friend void     divide(const Integer& x, const Integer& y, 
@@ -198,11 +258,30 @@ public:
   friend void     rshift(const Integer& x, const Integer& y, Integer& dest);
   friend void     pow(const Integer& x, const Integer& y, Integer& dest);
 
-  friend int      compare(const Integer&, long);  
+  friend int      compare(const Integer &x, long y)
+  {
+    if (x.rep) return CompareRep(x, y);
+    return (x.val > y) - (x.val < y);
+  }
   friend int      ucompare(const Integer&, long); 
-  friend void     add(const Integer& x, long y, Integer& dest);
-  friend void     sub(const Integer& x, long y, Integer& dest);
-  friend void     mul(const Integer& x, long y, Integer& dest);
+  friend void     add(const Integer& x, long y, Integer& dest)
+  {
+    long r;
+    if (x.rep || !AddLong(x.val, y, r)) AddRep(x, Integer(y), 0, dest);
+    else dest.Assign(r);
+  }
+  friend void     sub(const Integer& x, long y, Integer& dest)
+  {
+    long r;
+    if (x.rep || !SubLong(x.val, y, r)) AddRep(x, Integer(y), 1, dest);
+    else dest.Assign(r);
+  }
+  friend void     mul(const Integer& x, long y, Integer& dest)
+  {
+    long r;
+    if (x.rep || !MulLong(x.val, y, r)) MulRep(x, Integer(y), dest);
+    else dest.Assign(r);
+  }
   friend void     div(const Integer& x, long y, Integer& dest);
   friend void     mod(const Integer& x, long y, Integer& dest);
   friend void     divide(const Integer& x, long y, Integer& q, long& r);
@@ -210,19 +289,25 @@ public:
   friend void     rshift(const Integer& x, long y, Integer& dest);
   friend void     pow(const Integer& x, long y, Integer& dest);
 
-  friend int      compare(long, const Integer&);  
+  friend int      compare(long x, const Integer &y) { return -compare(y, x); }
   friend int      ucompare(long, const Integer&); 
-  friend void     add(long x, const Integer& y, Integer& dest);
+  friend void     add(long x, const Integer& y, Integer& dest) { add(y, x, dest); }
   friend void     sub(long x, const Integer& y, Integer& dest);
-  friend void     mul(long x, const Integer& y, Integer& dest);
+  friend void     mul(long x, const Integer& y, Integer& dest) { mul(y, x, dest); }
 
   // coercion & conversion
 
-  int             fits_in_long() const { return Iislong(rep); }
-  int             fits_in_double() const { return Iisdouble(rep); }
+  int             fits_in_long() const { return (rep) ? 0 : 1; }
+  int             fits_in_double() const { return (rep) ? Iisdouble(rep) : 1; }
 
-  long		  as_long() const { return Itolong(rep); }
-  double	  as_double() const { return Itodouble(rep); }
+  long		  as_long() const { return (rep) ? Itolong(rep) : val; }
+  double	  as_double() const 
+  {
+    // Larger longs are converted exactly as the arbitrary-precision
+    // form is, which need not round the same way as the compiler does
+    double d = (double) val;
+    return (rep || d >= 9007199254740992.0 || d <= -9007199254740992.0) ? AsDoubleRep() : d;
+  }
 
   friend std::string Itoa(const Integer &x, int base /*= 10*/, int width /*= 0*/);
   friend Integer atoI(const char *s, int base/*= 10*/);
@@ -235,6 +320,43 @@ public:
   int             initialized() const;
   void   error(const char* msg) const;
   int             OK() const;  
+
+private:
+  /// @name Machine-word arithmetic, returning false on overflow
+  //@{
+  static bool AddLong(long x, long y, long &r)
+#ifdef GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  { return !__builtin_add_overflow(x, y, &r); }
+#else
+  {
+    if ((y > 0 && x > LONG_MAX - y) || (y < 0 && x < LONG_MIN - y)) return false;
+    r = x + y;
+    return true;
+  }
+#endif  // GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  static bool SubLong(long x, long y, long &r)
+#ifdef GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  { return !__builtin_sub_overflow(x, y, &r); }
+#else
+  {
+    if ((y < 0 && x > LONG_MAX + y) || (y > 0 && x < LONG_MIN + y)) return false;
+    r = x - y;
+    return true;
+  }
+#endif  // GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  static bool MulLong(long x, long y, long &r)
+#ifdef GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  { return !__builtin_mul_overflow(x, y, &r); }
+#else
+  {
+    // Without the builtins, only products of half-words are done inline
+    const long half = 1L << (sizeof(long) * CHAR_BIT / 2 - 1);
+    if (x >= half || x <= -half || y >= half || y <= -half) return false;
+    r = x * y;
+    return true;
+  }
+#endif  // GAMBIT_INTEGER_OVERFLOW_BUILTINS
+  //@}
 };
 
 
@@ -34,14 +34,23 @@ template <class T> class BFS {
 private:
   std::map<int, T> m_map;
   T m_default;
+  // The sum of the hashes of the basic variables, maintained as they are
+  // inserted, so it does not depend on the order of insertion
+  size_t m_hash;
+
+  static size_t HashKey(int key) {
+    unsigned long long h = (unsigned long long) key * 0x9e3779b97f4a7c15ULL;
+    return (size_t) (h ^ (h >> 29));
+  }
 
 public:
   // Lifecycle
-  BFS(void) : m_default(0) { }
+  BFS(void) : m_default(0), m_hash(0) { }
   ~BFS()  { }
 
   // define two BFS's to be equal if their bases are equal
   bool operator==(const BFS &M) const {
+    if (m_hash != M.m_hash)  return false;
     if (m_map.size() != M.m_map.size())  return false;
 
     for (typename std::map<int, T>::const_iterator iter = m_map.begin();
@@ -58,10 +67,15 @@ public:
   int count(int key) const { return (m_map.count(key) > 0); }
 
   void insert(int key, const T &value) {
-    m_map.erase(key);
+    if (m_map.erase(key) == 0) {
+      m_hash += HashKey(key);
+    }
     m_map.insert(std::pair<int, T>(key, value));
   }
 
+  // A hash of the basis, consistent with operator==
+  size_t Hash(void) const { return m_hash; }
+
   const T &operator[](int key) const {
     if (m_map.count(key) == 1) {
       return const_cast<std::map<int, T> &>(m_map)[key];
@@ -72,6 +86,12 @@ public:
   }
 };
 
+// Hash function object, for keeping sets of BFS's
+template <class T> class BFSHash {
+public:
+  size_t operator()(const BFS<T> &p_bfs) const { return p_bfs.Hash(); }
+};
+
 }  // end namespace Gambit::linalg
 
 }  // end namespace Gambit
@@ -23,6 +23,8 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <atomic>
+#include <vector>
 #include "gambit/gambit.h"
 #include "gambit/linalg/basis.h"
 
@@ -32,45 +34,67 @@ namespace linalg {
     
 template <class T> class Tableau;
 
-// ---------------------------------------------------------------------------
-// Class EtaMatrix
-// ---------------------------------------------------------------------------
-
-template <class T> class EtaMatrix {
-  public:
-  int col;
-  Vector<T> etadata;
-  
-  EtaMatrix(int c, Vector<T> &v) : col(c), etadata(v) {}
-
-  // required for list class
-  bool operator==(const EtaMatrix<T> &) const;
-  bool operator!=(const EtaMatrix<T> &) const;
-};
-
 // ---------------------------------------------------------------------------
 // Class LUdecomp
 // ---------------------------------------------------------------------------
 
+//
+// A sparse LU factorization of the basis of a tableau.  The basis is
+// factored by Gaussian elimination, choosing pivots by the Markowitz
+// criterion (with threshold partial pivoting) to limit fill-in, and is
+// updated after each pivot by the method of Forrest and Tomlin, which
+// replaces a column of U and restores its triangularity with one row
+// eta.  Only nonzero entries are stored.
+//
+// Rows and basis positions are numbered from zero internally.
+//
 template <class T> class LUdecomp {
 private:
+  // An elementary matrix which differs from the identity in the
+  // entries of one column (for L) or one row (for the Forrest-Tomlin
+  // row etas R), stored sparsely
+  class SparseEta {
+  public:
+    int row;
+    std::vector<std::pair<int, T> > entries;
+  };
+
+  // The factors of the basis B, such that R L B = U: L and R are products
+  // of etas applied in order, and U is upper triangular after permuting
+  // its rows and columns into pivot order
+  class Factors {
+  public:
+    std::vector<SparseEta> L, R;
+    // The off-diagonal entries of each column of U, and its diagonal
+    std::vector<std::vector<std::pair<int, T> > > U;
+    std::vector<T> diag;
+    // The row and column of the pivot in each step, and the step at
+    // which each column is pivoted on
+    std::vector<int> pivotRow, pivotCol, colStep;
+    // The columns of U which have (or had) an entry in each row
+    std::vector<std::vector<int> > rowPattern;
+    // The number of nonzeros in L, R and U
+    long nonzeros;
+
+    Factors() : nonzeros(0) { }
+  };
+
   Tableau<T> &tab;
   Basis &basis;
 
-  List< EtaMatrix<T> > L;
-  List< EtaMatrix<T> > U;
-  List< EtaMatrix<T> > E;
-  List< int > P;
+  Factors factors;
 
-  Vector<T> scratch1; // scratch vectors so we don't reallocate them
-  Vector<T> scratch2; // everytime we do something.
+  // scratch vectors so we don't reallocate them everytime we do something
+  mutable std::vector<T> scratch1, scratch2;
+  Vector<T> column;
 
   int refactor_number;
   int iterations;
-  int total_operations;
+  long factor_nonzeros;
 
   const LUdecomp<T> *parent;
-  int copycount;
+  // Copies may be taken concurrently from several threads
+  std::atomic<int> copycount;
 
   // don't use this copy constructor
   LUdecomp( const LUdecomp<T> &a);
@@ -97,9 +121,9 @@ public:
     
 
   // copy constructor
-  // note:  Copying will fail an assertion if you try to update or delete
-  //        the original before the copy has been deleted, refactored
-  //        Or set to something else.
+  // note:  The copy shares the factors of the original until it is first
+  //        updated or refactored.  Copying will fail an assertion if you try 
+  //        to update or delete the original before then.
   LUdecomp( const LUdecomp<T> &, Tableau<T> & );
 
   // Decompose given matrix
@@ -128,7 +152,7 @@ public:
   // solve: y Bk = c
   void solveT( const Vector<T> &, Vector <T> & ) const;
 
-  // set number of etamatrices added before refactoring;
+  // set number of updates done before refactoring;
   // if number is set to zero, refactoring is done automatically.
   // if number is < 0, no refactoring is done;
   void SetRefactor( int );
@@ -139,32 +163,16 @@ public:
 
 private:
   
-  void FactorBasis();
-
-  void GaussElem( Matrix<T> &, int, int );
+  // the factors in use: those of the original, for a copy not yet updated
+  const Factors &GetFactors() const;
+  // takes a private copy of the factors shared with the original
+  void Detach();
 
-  bool CheckBasis();
+  void FactorBasis();
   bool RefactorCheck();
 
-  void BTransE( Vector<T> & ) const;
-  void FTransE( Vector<T> & ) const;
-  void BTransU( Vector<T> & ) const;
-  void FTransU( Vector<T> & ) const;
-  void LPd_Trans( Vector<T> & ) const;
-  void yLP_Trans( Vector<T> & ) const;
-
-  void VectorEtaSolve( const Vector<T> &v,  
-		      const EtaMatrix<T> &, 
-		      Vector<T> &y ) const;
-
-  void EtaVectorSolve( const Vector<T> &v, 
-		      const EtaMatrix<T> &,
-		      Vector<T> &d ) const;
-
-  void yLP_mult( const Vector<T> &y, int j, Vector<T> &) const;
-
-  void LPd_mult( Vector<T> &d, int j, Vector<T> &) const;
-
+  void FTransLR( const Factors &, std::vector<T> & ) const;
+  void BTransLR( const Factors &, std::vector<T> & ) const;
 
 };  // end of class LUdecomp
 
@@ -0,0 +1,200 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: library/include/gambit/linalg/sparselemke.h
+// Lemke tableau for linear complementarity problems with sparse matrices
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_LINALG_SPARSELEMKE_H
+#define GAMBIT_LINALG_SPARSELEMKE_H
+
+#include <map>
+#include <vector>
+#include "gambit/linalg/btableau.h"
+
+namespace Gambit {
+namespace linalg {
+
+///
+/// A matrix which stores only its nonzero entries, column by column.
+/// As with Matrix, rows and columns are indexed from arbitrary first
+/// indices.
+///
+template <class T> class SparseMatrix {
+public:
+  SparseMatrix(int p_minrow, int p_maxrow, int p_mincol, int p_maxcol)
+    : m_minrow(p_minrow), m_maxrow(p_maxrow), m_columns(p_mincol, p_maxcol)
+  { }
+
+  int MinRow(void) const { return m_minrow; }
+  int MaxRow(void) const { return m_maxrow; }
+  int MinCol(void) const { return m_columns.First(); }
+  int MaxCol(void) const { return m_columns.Last(); }
+
+  /// Returns the entry in row i and column j
+  T operator()(int i, int j) const;
+  /// Sets the entry in row i and column j; zero entries are not stored
+  void Set(int i, int j, const T &p_value);
+
+  /// Returns the nonzero entries of column j, indexed by row
+  const std::map<int, T> &GetColumn(int j) const { return m_columns[j]; }
+  /// Returns the number of nonzero entries in the matrix
+  long NumNonzeros(void) const;
+
+private:
+  int m_minrow, m_maxrow;
+  Array<std::map<int, T> > m_columns;
+};
+
+///
+/// A tableau for following Lemke paths on a linear complementarity
+/// problem whose matrix is sparse, as are those of the sequence form.
+/// Neither the matrix nor the inverse of the basis is ever stored
+/// densely.  The inverse of the basis is kept in product form, as a
+/// sequence of eta columns, one for each pivot, which are only as long
+/// as the transformed entering columns are dense; the product form is
+/// rebuilt from the basis columns once enough pivots have been done.
+///
+/// As for Tableau, the matrix and the constant vector are referenced,
+/// not copied.  Columns are read from the matrix when they are
+/// needed, so a change to a column which is not in the basis takes
+/// effect immediately; after changing a basic column, Refactor() must
+/// be called.
+///
+/// Copying a tableau is cheap: the eta columns are shared among copies,
+/// and each copy adds the eta columns of its own pivots.
+///
+template <class T> class SparseLemkeTableau {
+public:
+  class BadPivot : public Exception  {
+  public:
+    virtual ~BadPivot() throw() { }
+    const char *what(void) const throw() { return "Bad pivot in SparseLemkeTableau"; }
+  };
+  class BadExitIndex : public Exception  {
+  public:
+    virtual ~BadExitIndex() throw() { }
+    const char *what(void) const throw() { return "Bad exit index in SparseLemkeTableau"; }
+  };
+
+  /// @name Lifecycle
+  //@{
+  /// Creates the tableau with all the slack variables in the basis
+  SparseLemkeTableau(const SparseMatrix<T> &A, const Vector<T> &b);
+  SparseLemkeTableau(const SparseLemkeTableau<T> &);
+  ~SparseLemkeTableau() { }
+
+  SparseLemkeTableau<T> &operator=(const SparseLemkeTableau<T> &);
+  //@}
+
+  /// @name Information about the basis
+  //@{
+  int MinRow(void) const { return A->MinRow(); }
+  int MaxRow(void) const { return A->MaxRow(); }
+  int MinCol(void) const { return basis.MinCol(); }
+  int MaxCol(void) const { return basis.MaxCol(); }
+
+  /// Is the variable with the label in the basis?
+  bool Member(int label) const { return basis.Member(label); }
+  /// Returns the label of the variable in the i'th position of the basis
+  int Label(int i) const { return basis.Label(i); }
+  /// Returns the position in the basis of the variable with the label
+  int Find(int label) const { return basis.Find(label); }
+  long NumPivots(void) const { return npivots; }
+  T Epsilon(int i = 2) const;
+  //@}
+
+  /// @name Pivoting
+  //@{
+  /// Replaces the variable in position outrow by the variable with label col
+  void Pivot(int outrow, int col);
+  /// Computes the column of the variable with the label in the current basis
+  void SolveColumn(int col, Vector<T> &) const;
+  /// Computes the values of the basic variables
+  void BasisVector(Vector<T> &x) const;
+  /// Rebuilds the inverse of the basis from the columns of the matrix
+  void Refactor(void);
+  //@}
+
+  /// @name Following paths
+  //@{
+  int SF_PivotIn(int i);
+  int SF_ExitIndex(int i);
+  /// Follows a path of almost complementary bases from one
+  /// complementary basis to another
+  int SF_LCPPath(int dup);
+  //@}
+
+private:
+  /// A column of the product form of the inverse, which pivots on row
+  /// m_row, with m_pivot the entry in that row of the transformed
+  /// entering column, and m_entries its other nonzero entries
+  class EtaColumn {
+  public:
+    int m_row;
+    T m_pivot;
+    std::vector<std::pair<int, T> > m_entries;
+  };
+
+  /// A block of eta columns, following the eta columns of the block
+  /// m_prior.  Blocks are shared among copies of the tableau.
+  class EtaBlock {
+  public:
+    shared_ptr<EtaBlock> m_prior;
+    std::vector<EtaColumn> m_etas;
+  };
+
+  const SparseMatrix<T> *A;
+  const Vector<T> *b;
+  Basis basis;
+  long npivots;
+  T eps1, eps2;
+
+  /// The eta columns shared with other tableaus; copying a tableau
+  /// moves its own eta columns into a new shared block
+  mutable shared_ptr<EtaBlock> m_shared;
+  /// The eta columns of this tableau's own pivots since it was copied
+  mutable std::vector<EtaColumn> m_etas;
+  /// The number of eta columns, and the number in the last factorization
+  int m_numEtas, m_numFactorEtas;
+  /// The row pivoted on by the eta columns of the variable in each
+  /// position of the basis
+  Array<int> m_rows;
+  /// The values of the basic variables, indexed as the eta rows
+  Vector<T> m_solution;
+
+  /// Sets p_column to the column of the matrix for the label
+  void LoadColumn(int p_label, Vector<T> &p_column) const;
+  /// Applies the eta columns in order, transforming p_column in place.
+  /// If p_pattern is given, it lists the rows of the nonzero entries of
+  /// p_column, which are marked in p_marked, and rows which become
+  /// nonzero are added to it.
+  void ApplyEtas(Vector<T> &p_column, std::vector<int> *p_pattern = 0,
+		 Array<bool> *p_marked = 0) const;
+  /// Appends a new eta column pivoting on p_row for the transformed column,
+  /// whose nonzero entries are in the rows listed in p_pattern, if given
+  void AppendEta(int p_row, const Vector<T> &p_column,
+		 const std::vector<int> *p_pattern = 0);
+  /// Moves this tableau's own eta columns into a new shared block
+  void ShareEtas(void) const;
+};
+
+}  // end namespace Gambit::linalg
+}  // end namespace Gambit
+
+#endif  // GAMBIT_LINALG_SPARSELEMKE_H
@@ -34,6 +34,11 @@ Vector<T> operator*(const Vector<T> &, const Matrix<T> &);
 template <class T> class Matrix : public RectArray<T> {
 friend Vector<T> operator*<>(const Vector<T> &, const Matrix<T> &);
 public:
+  typedef typename RectArray<T>::RowView RowView;
+  typedef typename RectArray<T>::ConstRowView ConstRowView;
+  typedef typename RectArray<T>::ColumnView ColumnView;
+  typedef typename RectArray<T>::ConstColumnView ConstColumnView;
+
   /// @name Lifecycle
   //@{
   Matrix(void);
@@ -24,6 +24,7 @@
 #define LIBGAMBIT_MIXED_H
 
 #include "vector.h"
+#include "matrix.h"
 #include "gameagg.h"
 #include "gamebagg.h"
 
@@ -52,21 +53,8 @@ public:
   virtual T GetPayoff(int pl) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const = 0;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const = 0;
-};
-
-template <class T> class TreeMixedStrategyProfileRep 
-  : public MixedStrategyProfileRep<T> {
-public:
-  TreeMixedStrategyProfileRep(const StrategySupportProfile &p_support)
-    : MixedStrategyProfileRep<T>(p_support)
-  { }
-  TreeMixedStrategyProfileRep(const MixedBehaviorProfile<T> &);
-  virtual ~TreeMixedStrategyProfileRep() { }
-  
-  virtual MixedStrategyProfileRep<T> *Copy(void) const;
-  virtual T GetPayoff(int pl) const;
-  virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
-  virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetStrategyValues(PVector<T> &) const;
+  virtual void GetStrategyPairValues(Matrix<T> &) const;
 };
 
 template <class T> class TableMixedStrategyProfileRep
@@ -74,16 +62,23 @@ template <class T> class TableMixedStrategyProfileRep
 private:
   /// @name Private recursive payoff functions
   //@{
-  /// Recursive computation of payoff to player pl
-  T GetPayoff(int pl, int index, int i) const;
+  /// Recursive computation of payoff to a player
+  T GetPayoff(const Array<T> &p_payoffs, long index, int i) const;
   /// Recursive computation of payoff derivative
-  void GetPayoffDeriv(int pl, int const_pl, int cur_pl, long index,
-		      const T &prob, T &value) const;
+  void GetPayoffDeriv(const Array<T> &p_payoffs, int const_pl, int cur_pl,
+		      long index, const T &prob, T &value) const;
   /// Recursive computation of payoff second derivative
-  void GetPayoffDeriv(int pl, int const_pl1, int const_pl2, 
+  void GetPayoffDeriv(const Array<T> &p_payoffs, int const_pl1, int const_pl2, 
 		      int cur_pl, long index, const T &prob, T &value) const;
+  /// Collects the probabilities and table offsets of the support strategies
+  void GetSupportData(Array<Array<T> > &p_probs,
+		      Array<Array<long> > &p_offsets) const;
   //@}
 
+protected:
+  /// Returns the dense table of payoffs to player pl
+  virtual const Array<T> &GetPayoffTable(int pl) const;
+
 public:
   TableMixedStrategyProfileRep(const StrategySupportProfile &p_support)
     : MixedStrategyProfileRep<T>(p_support)
@@ -94,15 +89,66 @@ public:
   virtual T GetPayoff(int pl) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
   virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetStrategyValues(PVector<T> &) const;
+  virtual void GetStrategyPairValues(Matrix<T> &) const;
+};
+
+/// Profiles on trees are computed on the tables of the reduced strategic
+/// form when the game keeps them, and on the tree otherwise
+template <class T> class TreeMixedStrategyProfileRep 
+  : public TableMixedStrategyProfileRep<T> {
+private:
+  bool HasPayoffTable(void) const;
+
+protected:
+  virtual const Array<T> &GetPayoffTable(int pl) const;
+
+public:
+  TreeMixedStrategyProfileRep(const StrategySupportProfile &p_support)
+    : TableMixedStrategyProfileRep<T>(p_support)
+  { }
+  TreeMixedStrategyProfileRep(const MixedBehaviorProfile<T> &);
+  virtual ~TreeMixedStrategyProfileRep() { }
+  
+  virtual MixedStrategyProfileRep<T> *Copy(void) const;
+  virtual T GetPayoff(int pl) const;
+  virtual T GetPayoffDeriv(int pl, const GameStrategy &) const;
+  virtual T GetPayoffDeriv(int pl, const GameStrategy &, const GameStrategy &) const;
+  virtual void GetStrategyValues(PVector<T> &) const;
+  virtual void GetStrategyPairValues(Matrix<T> &) const;
 };
 
 template <class T> class AggMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// For each action of the AGG, the index of its probability in the
+  /// profile, or -1 if it is not in the support
+  std::vector<int> m_aggIndex;
+  /// The profile in the order of the actions of the AGG, and the scratch
+  /// space for the AGG's computations, kept so evaluating payoffs does
+  /// not allocate.  The scratch space is allocated on first use, and
+  /// is not shared with copies.
+  mutable std::vector<double> m_aggProfile;
+  mutable shared_ptr<agg::AGG::Workspace> m_workspace;
+
+  const agg::AGG &GetAgg(void) const
+  { return *dynamic_cast<GameAggRep &>(*this->m_support.GetGame()).aggPtr; }
+  agg::AGG::Workspace &GetWorkspace(void) const
+  {
+    if (!m_workspace.get()) m_workspace.reset(new agg::AGG::Workspace(GetAgg()));
+    return *m_workspace;
+  }
+  /// Copies the probabilities into m_aggProfile
+  void UpdateAggProfile(void) const;
+  /// Sets the strategy of the player of p_strategy in m_aggProfile to p_strategy
+  void SetPureStrategy(const GameStrategy &p_strategy) const;
 
 public:
-  AggMixedStrategyProfileRep(const StrategySupportProfile &p_support)
-   : MixedStrategyProfileRep<T>(p_support)
-    { }
+  AggMixedStrategyProfileRep(const StrategySupportProfile &p_support);
+  AggMixedStrategyProfileRep(const AggMixedStrategyProfileRep<T> &p_profile)
+    : MixedStrategyProfileRep<T>(p_profile),
+      m_aggIndex(p_profile.m_aggIndex), m_aggProfile(p_profile.m_aggProfile)
+  { }
   virtual ~AggMixedStrategyProfileRep() { }
 
   virtual MixedStrategyProfileRep<T> *Copy(void) const {
@@ -115,11 +161,38 @@ public:
 
 template <class T> class BagentMixedStrategyProfileRep
   : public MixedStrategyProfileRep<T> {
+private:
+  /// For each action of each type in the BAGG, the index of its
+  /// probability in the profile, or -1 if it is not in the support
+  std::vector<int> m_baggIndex;
+  /// The profile in the order of the actions of the BAGG, and the
+  /// scratch space for the BAGG's computations, kept so evaluating
+  /// payoffs does not allocate.  The scratch space is allocated on
+  /// first use, and is not shared with copies.
+  mutable std::vector<double> m_baggProfile;
+  mutable shared_ptr<agg::BAGG::Workspace> m_workspace;
+
+  agg::BAGG &GetBagg(void) const
+  { return *dynamic_cast<GameBagentRep &>(*this->m_support.GetGame()).baggPtr; }
+  agg::BAGG::Workspace &GetWorkspace(void) const
+  {
+    if (!m_workspace.get()) m_workspace.reset(new agg::BAGG::Workspace(GetBagg()));
+    return *m_workspace;
+  }
+  /// Copies the probabilities into m_baggProfile
+  void UpdateBaggProfile(void) const;
+  /// Sets the strategy of the player of p_strategy in m_baggProfile to p_strategy
+  void SetPureStrategy(const GameStrategy &p_strategy) const;
+  /// Returns the payoff of the player of the game for the type of the BAGG
+  /// player it represents, under the profile in m_baggProfile
+  T GetBaggPayoff(int pl) const;
 
 public:
-  BagentMixedStrategyProfileRep(const StrategySupportProfile &p_support)
-    : MixedStrategyProfileRep<T>(p_support)
-    { }
+  BagentMixedStrategyProfileRep(const StrategySupportProfile &p_support);
+  BagentMixedStrategyProfileRep(const BagentMixedStrategyProfileRep<T> &p_profile)
+    : MixedStrategyProfileRep<T>(p_profile),
+      m_baggIndex(p_profile.m_baggIndex), m_baggProfile(p_profile.m_baggProfile)
+  { }
   virtual ~BagentMixedStrategyProfileRep() { }
 
   virtual MixedStrategyProfileRep<T> *Copy(void) const {
@@ -253,6 +326,28 @@ public:
   T GetPayoff(const GameStrategy &p_strategy) const
   { return GetPayoffDeriv(p_strategy->GetPlayer()->GetNumber(), p_strategy); }
 
+  /// \brief Computes the payoffs to playing each pure strategy
+  ///
+  /// Computes the payoff to playing each strategy in the support against
+  /// the profile, as would be returned by GetPayoff(strategy).  The
+  /// vector is indexed by player and by the index of the strategy in
+  /// the support.  For strategic games, all the values are computed in
+  /// a single pass over the payoff table.
+  void GetStrategyValues(PVector<T> &p_values) const
+  { m_rep->GetStrategyValues(p_values); }
+
+  /// \brief Computes the payoffs to playing each pair of pure strategies
+  ///
+  /// Computes, for each pair of strategies s1 and s2 in the support
+  /// belonging to different players, the payoff to the player of s1
+  /// when s1 and s2 are played against the profile, as would be returned
+  /// by GetPayoffDeriv(pl, s1, s2).  The matrix is indexed by the
+  /// positions of s1 and s2 in the profile; entries for pairs of
+  /// strategies of the same player are zero.  For strategic games, all
+  /// the values are computed in a single pass over the payoff table.
+  void GetStrategyPairValues(Matrix<T> &p_values) const
+  { m_rep->GetStrategyPairValues(p_values); }
+
   /// \brief Computes the Lyapunov value of the profile
   ///
   /// Computes the Lyapunov value of the profile.  This is a nonnegative
@@ -29,7 +29,8 @@ namespace Gambit {
 
 namespace linalg {
 template <class T> class LHTableau;
-template <class T> class LemkeTableau;
+template <class T> class SparseMatrix;
+template <class T> class SparseLemkeTableau;
 }
 
 namespace Nash {
@@ -37,20 +38,23 @@ namespace Nash {
 template <class T> class NashLcpStrategySolver : public StrategySolver<T> {
 public:
   NashLcpStrategySolver(int p_stopAfter, int p_maxDepth,
-			Gambit::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0)
+			Gambit::shared_ptr<StrategyProfileRenderer<T> > p_onEquilibrium = 0,
+			int p_numThreads = 1)
     : StrategySolver<T>(p_onEquilibrium),
-      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth) { }
+      m_stopAfter(p_stopAfter), m_maxDepth(p_maxDepth),
+      m_numThreads(p_numThreads) { }
   virtual ~NashLcpStrategySolver()  { }
 
   virtual List<MixedStrategyProfile<T> > Solve(const Game &) const;
 
 private:
-  int m_stopAfter, m_maxDepth;
+  int m_stopAfter, m_maxDepth, m_numThreads;
 
   class Solution;
 
   bool OnBFS(const Game &, linalg::LHTableau<T> &, Solution &) const;
   void AllLemke(const Game &, int j, linalg::LHTableau<T> &, Solution &, int) const;
+  void AllLemkeParallel(const Game &, linalg::LHTableau<T> &, Solution &) const;
 };
 
  
@@ -69,11 +73,13 @@ private:
 
   class Solution;
 
-  void FillTableau(const BehaviorSupportProfile &, Matrix<T> &, const GameNode &, T,
-		   int, int, int, int, Solution &) const;
-  void AllLemke(const BehaviorSupportProfile &, int dup, Gambit::linalg::LemkeTableau<T> &B,
-	       int depth, Matrix<T> &, Solution &) const; 
-  void GetProfile(const BehaviorSupportProfile &, const Gambit::linalg::LemkeTableau<T> &tab, 
+  void FillTableau(const BehaviorSupportProfile &, linalg::SparseMatrix<T> &,
+		   const GameNode &, T, int, int, int, int, Solution &) const;
+  void AllLemke(const BehaviorSupportProfile &, int dup,
+		Gambit::linalg::SparseLemkeTableau<T> &B,
+		int depth, linalg::SparseMatrix<T> &, Solution &) const; 
+  void GetProfile(const BehaviorSupportProfile &,
+		  const Gambit::linalg::SparseLemkeTableau<T> &tab, 
 		  MixedBehaviorProfile<T> &, const Vector<T> &, 
 		  const GameNode &n, int, int,
 		  Solution &) const;
@@ -0,0 +1,201 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: library/include/gambit/nash/multistart.h
+// Run an equilibrium solver from many starting points in parallel
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef GAMBIT_NASH_MULTISTART_H
+#define GAMBIT_NASH_MULTISTART_H
+
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include "gambit/nash.h"
+
+namespace Gambit {
+namespace Nash {
+
+/// Returns true if the two profiles are the same equilibrium, that is,
+/// if they agree exactly (for rational profiles), or to within 1.0e-3
+/// in every probability (for floating-point profiles, which the solvers
+/// only locate approximately).
+inline bool IsSameEquilibrium(const Vector<double> &p_eqm1,
+			      const Vector<double> &p_eqm2)
+{
+  for (int i = p_eqm1.First(); i <= p_eqm1.Last(); i++) {
+    if (std::abs(p_eqm1[i] - p_eqm2[i]) > 1.0e-3) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool IsSameEquilibrium(const Vector<Rational> &p_eqm1,
+			      const Vector<Rational> &p_eqm2)
+{ return p_eqm1 == p_eqm2; }
+
+///
+/// Runs an equilibrium solver from each of a list of starting points
+/// (or perturbations), possibly spreading the starts over several
+/// threads.  Derived classes implement SolveStart(), which solves from
+/// one starting point, writing its output to the stream passed to it.
+///
+/// The output of each start is written out in the order of the starts,
+/// so the output is the same as solving the starts one after another,
+/// whatever the number of threads.  Optionally, the solve stops once
+/// the output written contains a given number of distinct equilibria;
+/// which starts are written out is also independent of the number of
+/// threads.
+///
+/// SolveStart() is called concurrently on the same object, and on
+/// the same game, when more than one thread is used.
+///
+template <class S, class P> class MultiStartSolver {
+public:
+  MultiStartSolver(int p_numThreads = 1, int p_stopAfter = 0)
+    : m_numThreads(p_numThreads), m_stopAfter(p_stopAfter)
+  { }
+  virtual ~MultiStartSolver() { }
+
+  /// Solves from one starting point, writing output to p_stream
+  virtual List<P> SolveStart(const S &p_start, std::ostream &p_stream) const = 0;
+
+  /// Solves from each of the starting points, writing output to p_stream.
+  /// Returns the distinct equilibria found from the starts written out.
+  List<P> Solve(const List<S> &p_starts, std::ostream &p_stream) const;
+
+private:
+  int m_numThreads, m_stopAfter;
+
+  class Result {
+  public:
+    bool m_done;
+    std::string m_output;
+    List<P> m_equilibria;
+    std::exception_ptr m_error;
+
+    Result(void) : m_done(false) { }
+  };
+
+  /// Adds the equilibria to the list, returning true once the list
+  /// contains as many distinct equilibria as requested
+  bool Collect(const List<P> &p_found, List<P> &p_distinct) const;
+};
+
+template <class S, class P>
+bool MultiStartSolver<S, P>::Collect(const List<P> &p_found,
+				     List<P> &p_distinct) const
+{
+  for (int i = 1; i <= p_found.Length(); i++) {
+    bool isNew = true;
+    for (int j = 1; isNew && j <= p_distinct.Length(); j++) {
+      isNew = !IsSameEquilibrium(p_found[i], p_distinct[j]);
+    }
+    if (isNew) {
+      p_distinct.push_back(p_found[i]);
+    }
+  }
+  return (m_stopAfter > 0 && p_distinct.Length() >= m_stopAfter);
+}
+
+template <class S, class P>
+List<P> MultiStartSolver<S, P>::Solve(const List<S> &p_starts,
+				      std::ostream &p_stream) const
+{
+  List<P> distinct;
+  if (m_numThreads <= 1 || p_starts.Length() <= 1) {
+    for (int i = 1; i <= p_starts.Length(); i++) {
+      if (Collect(SolveStart(p_starts[i], p_stream), distinct)) {
+	break;
+      }
+    }
+    return distinct;
+  }
+
+  // List caches its position when indexing, so the workers each
+  // access the starts through this array instead
+  Array<const S *> starts(p_starts.Length());
+  for (int i = 1; i <= p_starts.Length(); i++) {
+    starts[i] = &p_starts[i];
+  }
+  Array<Result> results(p_starts.Length());
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::atomic<int> next(1);
+  std::atomic<bool> stop(false);
+
+  // Each worker takes the next unsolved start until none remain
+  // or the solve is stopped
+  Array<std::thread *> workers(std::min(m_numThreads, p_starts.Length()));
+  for (int t = 1; t <= workers.Length(); t++) {
+    workers[t] = new std::thread([&]() {
+	for (int i = next++; !stop && i <= starts.Length(); i = next++) {
+	  std::ostringstream output;
+	  List<P> equilibria;
+	  std::exception_ptr error;
+	  try {
+	    equilibria = SolveStart(*starts[i], output);
+	  }
+	  catch (...) {
+	    error = std::current_exception();
+	  }
+	  std::lock_guard<std::mutex> lock(mutex);
+	  results[i].m_output = output.str();
+	  results[i].m_equilibria = equilibria;
+	  results[i].m_error = error;
+	  results[i].m_done = true;
+	  finished.notify_one();
+	}
+      });
+  }
+
+  // Write out the results in order as they become available
+  std::exception_ptr error;
+  for (int i = 1; i <= starts.Length(); i++) {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return results[i].m_done; });
+    if (results[i].m_error) {
+      error = results[i].m_error;
+      break;
+    }
+    p_stream << results[i].m_output;
+    if (Collect(results[i].m_equilibria, distinct)) {
+      break;
+    }
+  }
+
+  stop = true;
+  for (int t = 1; t <= workers.Length(); t++) {
+    workers[t]->join();
+    delete workers[t];
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return distinct;
+}
+
+}  // end namespace Gambit::Nash
+}  // end namespace Gambit
+
+#endif  // GAMBIT_NASH_MULTISTART_H
@@ -53,17 +53,37 @@ private:
   int m_gridResize, m_leashLength;
   bool m_verbose;
 
+  /// The payoffs of the game in each contingency, scaled by a common
+  /// denominator to integers
+  class PayoffTable;
+
   class State {
   public:
     int t, ibar;
     Rational d, pay, maxz, bestz;
     
-    State(void) : t(0), ibar(1), bestz(1.0e30) { }
+    State(const PayoffTable *p_table = 0)
+      : t(0), ibar(1), bestz(1.0e30), table(p_table) { }
     Rational getlabel(MixedStrategyProfile<Rational> &yy, Array<int> &, 
 		      PVector<Rational> &);
+
+  private:
+    /// With a payoff table, labels are computed from the payoffs to
+    /// the strategies at the point of the grid, scaled to integers.
+    /// These are updated for the coordinates of the point which have
+    /// changed since the last label, each of which is an integer
+    /// multiple of d.
+    const PayoffTable *table;
+    Array<Rational> lastY;
+    Array<Integer> grid, payoffs;
+    Integer gridSize;
+    Rational scale;
+
+    void updatePayoffs(const MixedStrategyProfile<Rational> &yy);
   };
 
-  Rational Simplex(MixedStrategyProfile<Rational> &, const Rational &d) const;
+  Rational Simplex(MixedStrategyProfile<Rational> &, const Rational &d,
+		   const PayoffTable *) const;
   void update(State &, RectArray<int> &, RectArray<int> &, PVector<Rational> &,
 	      const PVector<int> &, int j, int i) const;
   void getY(State &, MixedStrategyProfile<Rational> &x, PVector<Rational> &, 
@@ -39,6 +39,16 @@ public:
     : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
       m_double((double) m_rational)
   { }
+  /// Constructs the number with the given text and value, without
+  /// converting the text
+  Number(const std::string &p_text, const Rational &p_value)
+    : m_text(p_text), m_rational(p_value), m_double((double) m_rational)
+  { }
+  /// Constructs the number from the text in [p_begin, p_end)
+  Number(const char *p_begin, const char *p_end)
+    : m_text(p_begin, p_end), m_rational(TextToRational(p_begin, p_end)),
+      m_double((double) m_rational)
+  { }
   
   Number &operator=(const std::string &p_text)
   {
@@ -118,6 +118,11 @@ public:
 // Naming compatible with Boost's lexical_cast concept for potential future compatibility.
 template<> Rational lexical_cast(const std::string &);
 
+/// Converts the text in [p_begin, p_end) to a rational, accepting the
+/// same formats as lexical_cast<Rational>().  Throws ValueException
+/// if the text is not a number.
+Rational TextToRational(const char *p_begin, const char *p_end);
+
 } // end namespace Gambit
 
 #endif // LIBGAMBIT_RATIONAL_H
@@ -23,17 +23,72 @@
 #ifndef LIBGAMBIT_RECARRAY_H
 #define LIBGAMBIT_RECARRAY_H
 
+#include <algorithm>
 #include "gambit/gambit.h"
 
 namespace Gambit {
 
-/// This class implements a rectangular (two-dimensional) array
+/// This class implements a rectangular (two-dimensional) array.
+///
+/// The entries are stored contiguously, row by row.  Indexing with
+/// operator() checks both indices.  For inner loops, ViewRow() and
+/// ViewColumn() return views of a row or column, which check the index
+/// of the row or column once when they are made, and then index its
+/// entries (by column or row, respectively) without checking.
 template <class T> class RectArray {
 protected:
   int minrow, maxrow, mincol, maxcol;
-  T **data;
+  /// The entries, row by row
+  T *data;
+
+  /// Allocates the storage for the current dimensions
+  void Allocate(void)
+  {
+    int size = NumRows() * NumColumns();
+    data = (size > 0) ? new T[size] : 0;
+  }
+  /// Returns a pointer to row r, offset to be indexed by column
+  T *RowPointer(int r) const
+  { return data + (r - minrow) * (maxcol - mincol + 1) - mincol; }
 
 public:
+  /// An unchecked view of a row, indexed by column
+  class RowView {
+  private:
+    T *m_data;
+  public:
+    explicit RowView(T *p_data) : m_data(p_data) { }
+    T &operator[](int c) const { return m_data[c]; }
+  };
+  /// An unchecked view of a row of a constant array, indexed by column
+  class ConstRowView {
+  private:
+    const T *m_data;
+  public:
+    explicit ConstRowView(const T *p_data) : m_data(p_data) { }
+    ConstRowView(const RowView &p_row) : m_data(&p_row[0]) { }
+    const T &operator[](int c) const { return m_data[c]; }
+  };
+  /// An unchecked view of a column, indexed by row
+  class ColumnView {
+  private:
+    T *m_data;
+    int m_stride;
+  public:
+    ColumnView(T *p_data, int p_stride) : m_data(p_data), m_stride(p_stride) { }
+    T &operator[](int r) const { return m_data[r * m_stride]; }
+  };
+  /// An unchecked view of a column of a constant array, indexed by row
+  class ConstColumnView {
+  private:
+    const T *m_data;
+    int m_stride;
+  public:
+    ConstColumnView(const T *p_data, int p_stride)
+      : m_data(p_data), m_stride(p_stride) { }
+    const T &operator[](int r) const { return m_data[r * m_stride]; }
+  };
+
   /// @name Lifecycle
   //@{
   RectArray(void);
@@ -61,6 +116,24 @@ public:
   const T &operator()(int r, int c) const;
   //@}
 
+  /// @name Views of rows and columns
+  //@{
+  RowView ViewRow(int r)
+  { if (!CheckRow(r))  throw IndexException();  return RowView(RowPointer(r)); }
+  ConstRowView ViewRow(int r) const
+  { if (!CheckRow(r))  throw IndexException();  return ConstRowView(RowPointer(r)); }
+  ColumnView ViewColumn(int c)
+  { 
+    if (!CheckColumn(c))  throw IndexException();
+    return ColumnView(RowPointer(0) + c, NumColumns());
+  }
+  ConstColumnView ViewColumn(int c) const
+  { 
+    if (!CheckColumn(c))  throw IndexException();
+    return ConstColumnView(RowPointer(0) + c, NumColumns());
+  }
+  //@}
+
   /// @name Row and column rotation operators
   //@{
   void RotateUp(int lo, int hi);
@@ -150,59 +223,48 @@ template <class T> RectArray<T>::RectArray(unsigned int rows,
 						 unsigned int cols)
   : minrow(1), maxrow(rows), mincol(1), maxcol(cols)
 {
-  data = (rows > 0) ? new T *[maxrow] - 1 : 0;
-  for (int i = 1; i <= maxrow;
-       data[i++] = (cols > 0) ? new T[maxcol] - 1 : 0);
+  Allocate();
 }
 
 template <class T>
 RectArray<T>::RectArray(int minr, int maxr, int minc, int maxc)
   : minrow(minr), maxrow(maxr), mincol(minc), maxcol(maxc)
 {
-  data = (maxrow >= minrow) ? new T *[maxrow - minrow + 1] - minrow : 0;
-  for (int i = minrow; i <= maxrow;
-       data[i++] = (maxcol - mincol + 1) ? new T[maxcol - mincol + 1] - mincol : 0);
+  Allocate();
 }
 
 template <class T> RectArray<T>::RectArray(const RectArray<T> &a)
   : minrow(a.minrow), maxrow(a.maxrow), mincol(a.mincol), maxcol(a.maxcol)
 {
-  data = (maxrow >= minrow) ? new T *[maxrow - minrow + 1] - minrow : 0;
-  for (int i = minrow; i <= maxrow; i++)  {
-    data[i] = (maxcol >= mincol) ? new T[maxcol - mincol + 1] - mincol : 0;
-    for (int j = mincol; j <= maxcol; j++)
-      data[i][j] = a.data[i][j];
-  }
+  Allocate();
+  std::copy(a.data, a.data + NumRows() * NumColumns(), data);
 }
 
 template <class T> RectArray<T>::~RectArray()
 {
-  for (int i = minrow; i <= maxrow; i++)
-    if (data[i])  delete [] (data[i] + mincol);
-  if (data)  delete [] (data + minrow);
+  if (data)  delete [] data;
 }
 
 template <class T>
 RectArray<T> &RectArray<T>::operator=(const RectArray<T> &a)
 {
   if (this != &a)   {
-    int i;
-    for (i = minrow; i <= maxrow; i++)
-      if (data[i])  delete [] (data[i] + mincol);
-    if (data)  delete [] (data + minrow);
-
-    minrow = a.minrow;
-    maxrow = a.maxrow;
-    mincol = a.mincol;
-    maxcol = a.maxcol;
-    
-    data = (maxrow >= minrow) ? new T *[maxrow - minrow + 1] - minrow : 0;
-  
-    for (i = minrow; i <= maxrow; i++)  {
-      data[i] = (maxcol >= mincol) ? new T[maxcol - mincol + 1] - mincol : 0;
-      for (int j = mincol; j <= maxcol; j++)
-	data[i][j] = a.data[i][j];
+    // We only reallocate if the size changes
+    if (NumRows() * NumColumns() != a.NumRows() * a.NumColumns()) {
+      if (data)  delete [] data;
+      minrow = a.minrow;
+      maxrow = a.maxrow;
+      mincol = a.mincol;
+      maxcol = a.maxcol;
+      Allocate();
+    }
+    else {
+      minrow = a.minrow;
+      maxrow = a.maxrow;
+      mincol = a.mincol;
+      maxcol = a.maxcol;
     }
+    std::copy(a.data, a.data + NumRows() * NumColumns(), data);
   }
     
   return *this;
@@ -213,10 +275,10 @@ RectArray<T> &RectArray<T>::operator=(const RectArray<T> &a)
 //------------------------------------------------------------------------
 
 template <class T> int RectArray<T>::NumRows(void) const
-{ return maxrow - minrow + 1; }
+{ return (maxrow >= minrow) ? maxrow - minrow + 1 : 0; }
 
 template <class T> int RectArray<T>::NumColumns(void) const
-{ return maxcol - mincol + 1; }
+{ return (maxcol >= mincol) ? maxcol - mincol + 1 : 0; }
 
 template <class T> int RectArray<T>::MinRow(void) const    { return minrow; }
 template <class T> int RectArray<T>::MaxRow(void) const    { return maxrow; }
@@ -227,14 +289,14 @@ template <class T> T &RectArray<T>::operator()(int r, int c)
 {
   if (!Check(r, c))  throw IndexException();
 
-  return data[r][c];
+  return RowPointer(r)[c];
 }
 
 template <class T> const T &RectArray<T>::operator()(int r, int c) const
 {
   if (!Check(r, c))  throw IndexException();
 
-  return data[r][c];
+  return RowPointer(r)[c];
 }
 
 //------------------------------------------------------------------------
@@ -245,33 +307,25 @@ template <class T> void RectArray<T>::RotateUp(int lo, int hi)
 {
   if (lo < minrow || hi < lo || maxrow < hi)  throw IndexException();
 
-  T *temp = data[lo];
-  for (int k = lo; k < hi; k++)
-    data[k] = data[k + 1];
-  data[hi] = temp;
+  std::rotate(RowPointer(lo) + mincol, RowPointer(lo + 1) + mincol,
+	      RowPointer(hi + 1) + mincol);
 }
 
 template <class T> void RectArray<T>::RotateDown(int lo, int hi)
 {
   if (lo < minrow || hi < lo || maxrow < hi)  throw IndexException();
 
-  T *temp = data[hi];
-  for (int k = hi; k > lo; k--)
-    data[k] = data[k - 1];
-  data[lo] = temp;
+  std::rotate(RowPointer(lo) + mincol, RowPointer(hi) + mincol,
+	      RowPointer(hi + 1) + mincol);
 }
 
 template <class T> void RectArray<T>::RotateLeft(int lo, int hi)
 {
   if (lo < mincol || hi < lo || maxcol < hi)   throw IndexException();
   
-  T temp;
   for (int i = minrow; i <= maxrow; i++)  {
-    T *row = data[i];
-    temp = row[lo];
-    for (int j = lo; j < hi; j++)
-      row[j] = row[j + 1];
-    row[hi] = temp;
+    T *row = RowPointer(i);
+    std::rotate(row + lo, row + lo + 1, row + hi + 1);
   }
 }
 
@@ -280,11 +334,8 @@ template <class T> void RectArray<T>::RotateRight(int lo, int hi)
   if (lo < mincol || hi < lo || maxcol < hi)   throw IndexException();
 
   for (int i = minrow; i <= maxrow; i++)  {
-    T *row = data[i];
-    T temp = row[hi];
-    for (int j = hi; j > lo; j--)
-      row[j] = row[j - 1];
-    row[lo] = temp;
+    T *row = RowPointer(i);
+    std::rotate(row + lo, row + hi, row + hi + 1);
   }
 }
 
@@ -297,7 +348,7 @@ template <class T> void RectArray<T>::SwitchRow(int row, Array<T> &v)
   if (!CheckRow(row))  throw IndexException();
   if (!CheckRow(v))    throw DimensionException();
 
-  T *rowptr = data[row];
+  T *rowptr = RowPointer(row);
   T tmp;
   for (int i = mincol; i <= maxcol; i++)  {
     tmp = rowptr[i];
@@ -309,9 +360,10 @@ template <class T> void RectArray<T>::SwitchRow(int row, Array<T> &v)
 template <class T> void RectArray<T>::SwitchRows(int i, int j)
 {
   if (!CheckRow(i) || !CheckRow(j))   throw IndexException();
-  T *temp = data[j];
-  data[j] = data[i];
-  data[i] = temp;
+  if (i != j) {
+    std::swap_ranges(RowPointer(i) + mincol, RowPointer(i) + maxcol + 1,
+		     RowPointer(j) + mincol);
+  }
 }
 
 template <class T> void RectArray<T>::GetRow(int row, Array<T> &v) const
@@ -319,7 +371,7 @@ template <class T> void RectArray<T>::GetRow(int row, Array<T> &v) const
   if (!CheckRow(row))   throw IndexException();
   if (!CheckRow(v))     throw DimensionException();
 
-  T *rowptr = data[row];
+  const T *rowptr = RowPointer(row);
   for (int i = mincol; i <= maxcol; i++)
     v[i] = rowptr[i];
 }
@@ -329,7 +381,7 @@ template <class T> void RectArray<T>::SetRow(int row, const Array<T> &v)
   if (!CheckRow(row))   throw IndexException();
   if (!CheckRow(v))     throw DimensionException();
 
-  T *rowptr = data[row];
+  T *rowptr = RowPointer(row);
   for (int i = mincol; i <= maxcol; i++)
     rowptr[i] = v[i];
 }
@@ -343,9 +395,10 @@ template <class T> void RectArray<T>::SwitchColumn(int col, Array<T> &v)
   if (!CheckColumn(col))   throw IndexException();
   if (!CheckColumn(v))     throw DimensionException();
 
+  ColumnView column = ViewColumn(col);
   for (int i = minrow; i <= maxrow; i++)   {
-    T tmp = data[i][col];
-    data[i][col] = v[i];
+    T tmp = column[i];
+    column[i] = v[i];
     v[i] = tmp;
   }
 }
@@ -355,9 +408,10 @@ template <class T> void RectArray<T>::SwitchColumns(int a, int b)
   if (!CheckColumn(a) || !CheckColumn(b))   throw IndexException();
 
   for (int i = minrow; i <= maxrow; i++)   {
-    T tmp = data[i][a];
-    data[i][a] = data[i][b];
-    data[i][b] = tmp;
+    T *row = RowPointer(i);
+    T tmp = row[a];
+    row[a] = row[b];
+    row[b] = tmp;
   }
 }
 
@@ -366,8 +420,9 @@ template <class T> void RectArray<T>::GetColumn(int col, Array<T> &v) const
   if (!CheckColumn(col))  throw IndexException();
   if (!CheckColumn(v))    throw DimensionException();
 
+  ConstColumnView column = ViewColumn(col);
   for (int i = minrow; i <= maxrow; i++)
-    v[i] = data[i][col];
+    v[i] = column[i];
 }
 
 template <class T> void RectArray<T>::SetColumn(int col, const Array<T> &v)
@@ -375,8 +430,9 @@ template <class T> void RectArray<T>::SetColumn(int col, const Array<T> &v)
   if (!CheckColumn(col))   throw IndexException();
   if (!CheckColumn(v))     throw DimensionException();
 
+  ColumnView column = ViewColumn(col);
   for (int i = minrow; i <= maxrow; i++)
-    data[i][col] = v[i];
+    column[i] = v[i];
 }
 
 //-------------------------------------------------------------------------
@@ -387,9 +443,12 @@ template <class T> RectArray<T> RectArray<T>::Transpose(void) const
 {
   RectArray<T> tmp(mincol, maxcol, minrow, maxrow);
  
-  for (int i = minrow; i <= maxrow; i++)
-    for (int j = mincol; j <= maxrow; j++)
-      tmp(j,i) = (*this)(i,j);
+  for (int i = minrow; i <= maxrow; i++) {
+    ConstRowView row = ViewRow(i);
+    ColumnView column = tmp.ViewColumn(i);
+    for (int j = mincol; j <= maxcol; j++)
+      column[j] = row[j];
+  }
 
   return tmp;
 }
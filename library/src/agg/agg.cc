@@ -45,7 +45,6 @@ AGG::AGG(int numPlayers,int* _actions, int numANodes, int _numPNodes,
  vector<vector<vector<config> > >& proj,
  vector<vector<proj_func*> > & projF,
  vector<vector<vector<int> > >& Po,
- vector<aggdistrib> &P,
  vector<aggpayoff>& _payoffs) :
 numPlayers(numPlayers),
 numActionNodes(numANodes),
@@ -55,14 +54,14 @@ neighbors(neighb),
 projectionTypes(projTypes),
 payoffs(_payoffs),
 projection(proj),
-projectedStrat(projS),
 fullProjectedStrat(projS),
 projFunctions(projF),
 Porder(Po),
-Pr(P),
 isPure(numANodes,true),
 node2Action(numANodes,vector<int>(numPlayers)),
-cache(numPlayers+1),
+isDense(numANodes,false),
+densePayoffs(numANodes),
+denseProjection(numANodes),
 player2Class(numPlayers),
 kSymStrategyOffset(1,0)
 {
@@ -133,6 +132,7 @@ kSymStrategyOffset(1,0)
     for(int j=0;j<actions[i];j++)
 	node2Action[actionSets[i][j]][i]=j;
 
+  initDense();
 }
 
 /*
@@ -390,7 +390,7 @@ AGG *AGG::makeAGG(istream &in){
       
     }
     AGG *r=NULL;
-    r=new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    r=new AGG(n,size,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     if (!r)cout<<"Failed to allocate memory for new AGG";
     delete [] size;
     return r;
@@ -461,7 +461,7 @@ vector<projtype>& projTypes, int seed, bool int_payoffs, int int_factor){
 	    numPayoffs += pays[i].size();
     }
     cout << "Creating an AGG with "<<numPayoffs <<" payoff values"<<endl;
-    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,Pr,pays);
+    AGG *r= new AGG(n,actions,S,P,ASets,neighb,projTypes,projS,proj,projF,Po,pays);
     
     return r;
  
@@ -583,8 +583,11 @@ AGG::initPorder(vector<int>& Po,
 
 //compute the induced distribution 
 void
-AGG::computeP(int player, int act, int player2,int act2)
+AGG::computeP(int player, int act, Workspace &w, int player2,int act2) const
 {
+  vector<aggdistrib> &Pr = w.Pr;
+  const vector<aggdistrib> &projectedStrat = w.getProjectedStrat(actionSets[player][act]);
+
   //apply player's strat
   Pr[0].reset();
   Pr[0].insert(make_pair(projection[actionSets[player][act]][player][act], 1.0) );
@@ -605,29 +608,327 @@ AGG::computeP(int player, int act, int player2,int act2)
       }
     } else {
       Pr[k].multiply (Pr[k-1], 
-	projectedStrat[actionSets[player][act]][Porder[player][act][k]],
+	projectedStrat[Porder[player][act][k]],
 	numNei  ,projFunctions[actionSets[player][act]] ); 
     }
   }
     
 }
 
-void AGG:: doProjection(int Node, AggNumber* s)
+void
+AGG::computeNodeP(int Node, Workspace &w) const
+{
+  const vector<aggdistrib> &projectedStrat = w.getProjectedStrat(Node);
+  const vector<proj_func*> &f = projFunctions[Node];
+  int numNei = neighbors[Node].size();
+  if (w.nodeP.empty()) {
+    w.nodeP.resize(numPlayers);
+    w.prefix.resize(numPlayers);
+    w.suffix.resize(numPlayers);
+  }
+  vector<aggdistrib> &prefix = w.prefix, &suffix = w.suffix;
+
+  //as in initPorder(), take the agents with the fewest projected
+  //actions first, to keep the partial products small
+  vector<pair<int,int> > order;
+  for (int k=0;k<numPlayers;k++){
+    order.push_back(make_pair(projectedStrat[k].size(), k));
+  }
+  sort(order.begin(),order.end());
+
+  //prefix[t]: the distribution induced by the agents order[0..t];
+  //suffix[t]: the distribution induced by the agents order[t..n-1]
+  prefix[0] = projectedStrat[order[0].second];
+  for (int t=1; t<numPlayers-1; t++){
+    prefix[t].multiply(prefix[t-1], projectedStrat[order[t].second], numNei, f);
+  }
+  suffix[numPlayers-1] = projectedStrat[order[numPlayers-1].second];
+  for (int t=numPlayers-2; t>=1; t--){
+    suffix[t].multiply(projectedStrat[order[t].second], suffix[t+1], numNei, f);
+  }
+
+  //chainCost[t]: the estimated cost of extending prefix[t-1] by the
+  //agents after t one at a time, which is cheaper than multiplying
+  //prefix[t-1] and suffix[t+1] when the neighbourhood is large
+  vector<double> chainCost(numPlayers+1, 0.0);
+  for (int t=numPlayers-2; t>=1; t--){
+    chainCost[t] = chainCost[t+1] +
+      (double) prefix[t].size() * (double) projectedStrat[order[t+1].second].size();
+  }
+
+  for (int t=0; t<numPlayers; t++){
+    int player = order[t].second;
+    if (node2Action[Node][player] < 0) continue;
+    aggdistrib &dest = w.nodeP[player];
+    if (t == 0) {
+      dest = suffix[1];
+    }
+    else if (t == numPlayers-1) {
+      dest = prefix[numPlayers-2];
+    }
+    else if ((double) prefix[t-1].size() * (double) suffix[t+1].size() <= chainCost[t]) {
+      dest.multiply(prefix[t-1], suffix[t+1], numNei, f);
+    }
+    else {
+      dest = prefix[t-1];
+      for (int k=t+1; k<numPlayers; k++){
+	dest.multiply(projectedStrat[order[k].second], numNei, f);
+      }
+    }
+  }
+}
+
+void
+AGG::initDense()
+{
+  for (int Node=0; Node<numActionNodes; Node++){
+    int numNei = neighbors[Node].size();
+    bool dense = true;
+    for (int k=0; k<numNei; k++){
+      TypeEnum t = projFunctions[Node][k]->Type;
+      if (t != P_SUM && t != P_SUM2) dense = false;
+    }
+    if (!dense) continue;
+
+    //the box bounding all the partial configurations: with nonnegative
+    //contributions, these are at most the sums of the agents' largest
+    vector<int> maxConfig(numNei, 0);
+    for (int i=0; i<numPlayers; i++){
+      for (int k=0; k<numNei; k++){
+	int most = 0;
+	for (int j=0; j<actions[i]; j++){
+	  if (projection[Node][i][j][k] < 0) dense = false;
+	  most = max(most, projection[Node][i][j][k]);
+	}
+	maxConfig[k] += most;
+      }
+    }
+    vector<int> radix(numNei, 1);
+    long size = 1;
+    for (int k=0; k<numNei && dense; k++){
+      radix[k] = size;
+      size *= maxConfig[k]+1;
+      if (size > MAX_DENSE_CONFIGS) dense = false;
+    }
+    if (size > (long) MAX_DENSE_RATIO * (long) payoffs[Node].size()) dense = false;
+    for (aggpayoff::const_iterator p=payoffs[Node].begin(); dense && p!=payoffs[Node].end(); ++p){
+      for (int k=0; k<numNei; k++){
+	if (p->first[k] < 0 || p->first[k] > maxConfig[k]) dense = false;
+      }
+    }
+    if (!dense) continue;
+
+    isDense[Node] = true;
+    densePayoffs[Node].assign(size, 0.0);
+    for (aggpayoff::const_iterator p=payoffs[Node].begin(); p!=payoffs[Node].end(); ++p){
+      int index = 0;
+      for (int k=0; k<numNei; k++) index += p->first[k] * radix[k];
+      densePayoffs[Node][index] = p->second;
+    }
+    denseProjection[Node].resize(numPlayers);
+    for (int i=0; i<numPlayers; i++){
+      denseProjection[Node][i].resize(actions[i]);
+      for (int j=0; j<actions[i]; j++){
+	int index = 0;
+	for (int k=0; k<numNei; k++) index += projection[Node][i][j][k] * radix[k];
+	denseProjection[Node][i][j] = index;
+      }
+    }
+  }
+}
+
+void
+AGG::doDenseProjection(int Node, int i, const AggNumber* s, Workspace &w) const
+{
+  if (w.denseStrat.empty()) w.denseStrat.resize(numPlayers);
+  vector<pair<int,AggNumber> > &dest = w.denseStrat[i];
+  dest.clear();
+  for (int j=0;j<actions[i];j++)if(s[j]>(AggNumber)0.0){
+    int index = denseProjection[Node][i][j];
+    size_t k = 0;
+    while (k < dest.size() && dest[k].first != index) k++;
+    if (k < dest.size()) dest[k].second += s[j];
+    else dest.push_back(make_pair(index, s[j]));
+  }
+}
+
+namespace {
+
+//dest = src * strat, where src is nonzero only in [lo,hi], which is
+//updated to the part of dest which may be nonzero.
+void denseMultiply(const AggNumber *src, int &lo, int &hi,
+		   const vector<pair<int,AggNumber> > &strat, AggNumber *dest)
+{
+  int minIndex = strat[0].first, maxIndex = strat[0].first;
+  for (size_t a=1; a<strat.size(); a++){
+    minIndex = min(minIndex, strat[a].first);
+    maxIndex = max(maxIndex, strat[a].first);
+  }
+  fill(dest+lo+minIndex, dest+hi+maxIndex+1, (AggNumber) 0.0);
+  for (size_t a=0; a<strat.size(); a++){
+    AggNumber *d = dest + strat[a].first;
+    const AggNumber p = strat[a].second;
+    for (int x=lo; x<=hi; x++) d[x] += p * src[x];
+  }
+  lo += minIndex;
+  hi += maxIndex;
+}
+
+//dest[x] = the expected value of src[x+c], where c is distributed as strat
+void denseExpect(const AggNumber *src, int size,
+		 const vector<pair<int,AggNumber> > &strat, AggNumber *dest)
+{
+  fill(dest, dest+size, (AggNumber) 0.0);
+  for (size_t a=0; a<strat.size(); a++){
+    const AggNumber *v = src + strat[a].first;
+    const AggNumber p = strat[a].second;
+    for (int x=0; x<size-strat[a].first; x++) dest[x] += p * v[x];
+  }
+}
+
+}
+
+AggNumber
+AGG::getDenseV(int player, int act, const StrategyProfile &s, Workspace &w,
+	       int player2, int act2) const
+{
+  int Node = actionSets[player][act];
+  const AggNumberVector &payoff = densePayoffs[Node];
+  if (w.dense.size() < payoff.size()) {
+    w.dense.resize(payoff.size());
+    w.denseScratch.resize(payoff.size());
+  }
+  AggNumber *P = &w.dense[0], *temp = &w.denseScratch[0];
+  int lo = denseProjection[Node][player][act], hi = lo;
+  P[lo] = 1.0;
+  vector<pair<int,AggNumber> > pure(1);
+  for (int k=1; k<numPlayers; k++){
+    int j = Porder[player][act][k];
+    const vector<pair<int,AggNumber> > *strat;
+    if (j == player2) {
+      if (act2 < 0) continue;
+      pure[0] = make_pair(denseProjection[Node][player2][act2], 1.0);
+      strat = &pure;
+    }
+    else {
+      doDenseProjection(Node, j, &s[firstAction(j)], w);
+      strat = &w.denseStrat[j];
+    }
+    if (strat->empty()) return 0.0;
+    if (strat->size() == 1 && (*strat)[0].first == 0 && (*strat)[0].second == 1.0) continue;
+    denseMultiply(P, lo, hi, *strat, temp);
+    std::swap(P, temp);
+  }
+  AggNumber result = 0.0;
+  for (int x=lo; x<=hi; x++) result += P[x] * payoff[x];
+  return result;
+}
+
+void
+AGG::getDensePayoffs(int Node, const StrategyProfile &s, AggNumberVector &dest,
+		     Workspace &w) const
+{
+  //Order the agents 0..n-1.  The payoff of agent t is
+  //  sum_x P_{t-1}[x] * E_{t+1}[x + own contribution of t],
+  //where P_{t-1} is the distribution induced by agents 0..t-1, and
+  //E_{t+1}[x] is the expected payoff given the partial configuration x
+  //of agents 0..t, over the strats of agents t+1..n-1.  The P are
+  //computed forwards and the E backwards, which takes time linear in n.
+  //To keep the space to O(sqrt(n)) tables, E_t is stored only when t is
+  //a multiple of K, and each block of the others is recomputed from
+  //the stored table above it as it is reached.
+  const AggNumberVector &payoff = densePayoffs[Node];
+  int size = payoff.size();
+  for (int i=0; i<numPlayers; i++){
+    doDenseProjection(Node, i, &s[firstAction(i)], w);
+  }
+  int n = numPlayers;
+  int K = 1;
+  while (K*K < n) K++;
+  //tables: [0, n/K] for the stored E_{cK}, [n/K+1, n/K+K-1] for the
+  //block being used, and the last two as scratch
+  int numStored = n/K + 1;
+  int numTables = numStored + K-1 + 2;
+  if ((int) w.denseTables.size() < numTables) w.denseTables.resize(numTables);
+  for (int t=0; t<numTables; t++){
+    if ((int) w.denseTables[t].size() < size) w.denseTables[t].resize(size);
+  }
+  AggNumber *scratch[2] = { &w.denseTables[numTables-2][0], &w.denseTables[numTables-1][0] };
+
+  //the backwards pass, storing E_t for the multiples t of K
+  const AggNumber *E = &payoff[0];
+  for (int t=n-1; t>=K; t--){
+    AggNumber *next = (t % K == 0) ? &w.denseTables[t/K][0] :
+      ((E == scratch[0]) ? scratch[1] : scratch[0]);
+    denseExpect(E, size, w.denseStrat[t], next);
+    E = next;
+  }
+
+  if (w.dense.size() < payoff.size()) {
+    w.dense.resize(payoff.size());
+    w.denseScratch.resize(payoff.size());
+  }
+  AggNumber *P = &w.dense[0], *temp = &w.denseScratch[0];
+  int lo = 0, hi = 0;
+  P[0] = 1.0;
+  int block = -1;
+  int lastOwner = n-1;
+  while (node2Action[Node][lastOwner] < 0) lastOwner--;
+  for (int t=0; t<=lastOwner; t++){
+    if (node2Action[Node][t] >= 0) {
+      //E_{t+1} is in the block of tables (bK, (b+1)K]
+      int b = t / K;
+      int top = min((b+1)*K, n);
+      const AggNumber *topTable = (top == n) ? &payoff[0] : &w.denseTables[top/K][0];
+      if (b != block) {
+	const AggNumber *above = topTable;
+	for (int u=top-1; u>b*K; u--){
+	  AggNumber *table = &w.denseTables[numStored + u-b*K-1][0];
+	  denseExpect(above, size, w.denseStrat[u], table);
+	  above = table;
+	}
+	block = b;
+      }
+      const AggNumber *Enext = (t+1 == top) ? topTable :
+	&w.denseTables[numStored + t+1-b*K-1][0];
+
+      int act = node2Action[Node][t];
+      const AggNumber *v = Enext + denseProjection[Node][t][act];
+      int last = min(hi, size-1-denseProjection[Node][t][act]);
+      AggNumber result = 0.0;
+      for (int x=lo; x<=last; x++) result += P[x] * v[x];
+      dest[firstAction(t)+act] = result;
+    }
+    if (t == lastOwner) break;
+    if (w.denseStrat[t].empty()) {
+      //the strat of agent t is zero, so are the payoffs of the agents after it
+      for (int u=t+1; u<n; u++)if(node2Action[Node][u] >= 0){
+	dest[firstAction(u)+node2Action[Node][u]] = 0.0;
+      }
+      break;
+    }
+    denseMultiply(P, lo, hi, w.denseStrat[t], temp);
+    std::swap(P, temp);
+  }
+}
+
+void AGG:: doProjection(int Node, const AggNumber* s, Workspace &w) const
 {
   for (int i=0;i<numPlayers;i++){
-    doProjection(Node,i, &(s[firstAction(i)]));
+    doProjection(Node,i, &(s[firstAction(i)]), w);
   }
 }
 
-inline void AGG:: doProjection(int Node, int i, AggNumber* s)
+void AGG:: doProjection(int Node, int i, const AggNumber* s, Workspace &w) const
 {
-  projectedStrat[Node][i].reset();
+  aggdistrib &projectedStrat = w.getProjectedStrat(Node)[i];
+  projectedStrat.reset();
   for (int j=0;j<actions[i];j++)if(s[j]>(AggNumber)0.0){
-    projectedStrat[Node][i]+= make_pair(projection[Node][i][j],
+    projectedStrat+= make_pair(projection[Node][i][j],
               s[j]);
   }
 }
-AggNumber AGG::getPurePayoff(int player, int *s){
+AggNumber AGG::getPurePayoff(int player, int *s) const {
   assert(player>=0 && player < numPlayers);
   int Node = actionSets[player][s[player]]; 
   int keylen = neighbors[Node].size();
@@ -638,7 +939,7 @@ AggNumber AGG::getPurePayoff(int player, int *s){
         (*projFunctions[Node][j]) (pureprofile[j],projection[Node][i][s[i]][j] );
     }
   }
-  aggpayoff::iterator p= payoffs[Node].find(pureprofile);
+  aggpayoff::const_iterator p= payoffs[Node].find(pureprofile);
   if ( p == payoffs[Node].end() ){
     cout<<"AGG::getPurePayoff ERROR: unable to find the following configuration"
         <<endl;
@@ -651,34 +952,79 @@ AggNumber AGG::getPurePayoff(int player, int *s){
   return p->second;
 }
 
-AggNumber AGG::getMixedPayoff(int player, StrategyProfile &s){
+AggNumber AGG::getMixedPayoff(int player, const StrategyProfile &s, Workspace &w) const {
   AggNumber result=0.0;
   assert(player>=0 && player < numPlayers);
   for (int act=0;act <actions[player];++act)if (s[act+firstAction(player)]>(AggNumber)0.0){
-	result+= s[act+firstAction(player)]* getV(player, act, s);
+	result+= s[act+firstAction(player)]* getV(player, act, s, w);
   }
   return result;
 }
 
-void AGG::getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s){
+void AGG::getPayoffVector(AggNumberVector &dest, int player,const StrategyProfile &s,
+                          Workspace &w) const {
     assert(player>=0 && player < numPlayers);
     for (int act=0;act<actions[player]; ++act){
-	dest[act]=getV(player,act,s);
+	dest[act]=getV(player,act,s,w);
     }
 }
 
-AggNumber AGG::getV(int player, int act,const StrategyProfile &s){
+AggNumber AGG::getV(int player, int act,const StrategyProfile &s, Workspace &w) const {
+    if (isDense[actionSets[player][act]]) return getDenseV(player, act, s, w);
     //project s to the projectedStrat
-    doProjection(actionSets.at(player).at(act), s);
-    computeP(player, act);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
+    doProjection(actionSets.at(player).at(act), s, w);
+    computeP(player, act, w);
+    return w.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player][act]]);
 }
 
-AggNumber AGG::getJ(int player1, int act1, int player2,int act2,StrategyProfile &s)
+AggNumber AGG::getJ(int player1, int act1, int player2,int act2,const StrategyProfile &s,
+                    Workspace &w) const
 {
-    doProjection(actionSets[player1][act1],s);
-    computeP(player1,act1,player2,act2);
-    return Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+    if (isDense[actionSets[player1][act1]]) return getDenseV(player1, act1, s, w, player2, act2);
+    doProjection(actionSets[player1][act1],s,w);
+    computeP(player1,act1,w,player2,act2);
+    return w.Pr[numPlayers-1].inner_prod(payoffs[actionSets[player1][act1]]);
+}
+
+void AGG::getPayoffVectors(AggNumberVector &dest, const StrategyProfile &s, Workspace &w) const
+{
+  for (int Node=0; Node<numActionNodes; Node++){
+    int numOwners = 0, owner = -1;
+    for (int i=0;i<numPlayers;i++){
+      if (node2Action[Node][i] >= 0) {
+	numOwners++;
+	owner = i;
+      }
+    }
+    if (numOwners == 0) continue;
+
+    if (isDense[Node]) {
+      if (numOwners == 1) {
+	dest[firstAction(owner)+node2Action[Node][owner]] =
+	  getDenseV(owner, node2Action[Node][owner], s, w);
+      }
+      else {
+	getDensePayoffs(Node, s, dest, w);
+      }
+      continue;
+    }
+
+    doProjection(Node, s, w);
+    if (numOwners == 1) {
+      int act = node2Action[Node][owner];
+      computeP(owner, act, w);
+      dest[firstAction(owner)+act] = w.Pr[numPlayers-1].inner_prod(payoffs[Node]);
+      continue;
+    }
+
+    computeNodeP(Node, w);
+    int numNei = neighbors[Node].size();
+    for (int i=0;i<numPlayers;i++)if(node2Action[Node][i] >= 0){
+      int act = node2Action[Node][i];
+      dest[firstAction(i)+act] = w.nodeP[i].inner_prod(projection[Node][i][act], numNei,
+						       projFunctions[Node], payoffs[Node]);
+    }
+  }
 }
 
 //getSymMixedPayoff: compute expected payoff under a symmetric mixed strat,
@@ -686,7 +1032,7 @@ AggNumber AGG::getJ(int player1, int act1, int player2,int act2,StrategyProfile
 // parameter: s is the mixed strategy of one player. It is a vector of 
 // probabilities, indexed by the action node.
 
-AggNumber AGG::getSymMixedPayoff( StrategyProfile &s){
+AggNumber AGG::getSymMixedPayoff(const StrategyProfile &s, Workspace &w) const {
   AggNumber result=0;
   if (! isSymmetric() ) {
     cerr<< "AGG::getSymMixedPayoff: the game is not symmetric!"<<endl;
@@ -695,11 +1041,11 @@ AggNumber AGG::getSymMixedPayoff( StrategyProfile &s){
 
 
   for (int node=0; node<numActionNodes; ++node)if(s[node]>(AggNumber)0.0){
-    result+= s[node]* getSymMixedPayoff(node,s);
+    result+= s[node]* getSymMixedPayoff(node,s,w);
   }
   return result;
 }
-void AGG::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
+void AGG::getSymPayoffVector(AggNumberVector& dest, const StrategyProfile &s, Workspace &w) const {
   if (! isSymmetric() ) {
     cerr<< "AGG::getSymMixedPayoff: the game is not symmetric!"<<endl;
     exit(1);
@@ -723,20 +1069,20 @@ void AGG::getSymPayoffVector(AggNumberVector& dest, StrategyProfile &s){
   //  return;
   //}
   for (int act=0;act<numActionNodes; ++act){
-          dest[act]=getSymMixedPayoff(act,s);
+          dest[act]=getSymMixedPayoff(act,s,w);
   }
 }
-AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
+AggNumber AGG::getSymMixedPayoff(int node, const StrategyProfile &s, Workspace &w) const
 {
     int numNei = neighbors[node].size();
 
     if(!isPure[node]){ // then compute EU using trie_map::power()
-      doProjection(node,0,s);
+      doProjection(node,0,s,w);
       assert(numPlayers>1);
       //aggdistrib *dest;
       //projectedStrat[node][0].power(numPlayers-1, dest, Pr, numNei,projFunctions[node]);
-      aggdistrib &dest = Pr[numPlayers-1];
-      projectedStrat[node][0].power(numPlayers-1, dest, Pr[numPlayers-2],numNei,projFunctions[node]);
+      aggdistrib &dest = w.Pr[numPlayers-1];
+      w.getProjectedStrat(node)[0].power(numPlayers-1, dest, w.Pr[numPlayers-2],numNei,projFunctions[node]);
       return dest.inner_prod(projection[node][0][node], numNei, projFunctions[node], payoffs[node]);
     }
 
@@ -791,7 +1137,8 @@ AggNumber AGG::getSymMixedPayoff(int node, StrategyProfile &s)
 //plClass: the index for the player class
 //s: mixed strat for that player class
 
-void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,int plClass2,int act2){
+void AGG::getSymConfigProb(int plClass, const StrategyProfile &s, int ownPlClass, int act, aggdistrib &dest,
+                           Workspace &w, int plClass2,int act2) const {
     int node = uniqueActionSets.at(ownPlClass).at(act);
     int numPl = playerClasses.at(plClass).size();
     assert(numPl>0);
@@ -806,12 +1153,13 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
 
     if(!isPure[node]){
       int player = playerClasses[plClass].at(0);
-      projectedStrat[node][player].reset();
+      aggdistrib &projectedStrat = w.getProjectedStrat(node)[player];
+      projectedStrat.reset();
       if(numPl>0){
         for (int j=0;j<actions[player];j++)if(s[j]>(AggNumber)0.0){
-          projectedStrat[node][player]+= make_pair(projection[node][player][j], s[j]);
+          projectedStrat+= make_pair(projection[node][player][j], s[j]);
         }
-        projectedStrat[node][player].power(numPl, dest,Pr[0],numNei, projFunctions[node]);
+        projectedStrat.power(numPl, dest,w.Pr[0],numNei, projFunctions[node]);
       }
       if(plClass==ownPlClass){
         aggdistrib temp;
@@ -896,50 +1244,54 @@ void AGG::getSymConfigProb(int plClass, StrategyProfile &s, int ownPlClass, int
   
 }
 
-AggNumber AGG::getKSymMixedPayoff( int playerClass,vector<StrategyProfile> &s){
+AggNumber AGG::getKSymMixedPayoff(int playerClass, const vector<StrategyProfile> &s,
+                                  Workspace &w) const {
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[playerClass][act]>(AggNumber)0.0){
 
-      result += s[playerClass][act] *getKSymMixedPayoff(playerClass, act,s);
+      result += s[playerClass][act] *getKSymMixedPayoff(playerClass, act,s,w);
   }
   return result;
 }
-AggNumber AGG::getKSymMixedPayoff( int playerClass,StrategyProfile &s){
+AggNumber AGG::getKSymMixedPayoff(int playerClass, const StrategyProfile &s, Workspace &w) const {
   AggNumber result=0.0;
 
   for(int act=0;act<(int)uniqueActionSets[playerClass].size();act++)if(s[firstKSymAction(playerClass)+act]>(AggNumber)0.0){
 
-      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(s,playerClass, act);
+      result += s[firstKSymAction(playerClass)+act] *getKSymMixedPayoff(s,playerClass, act,-1,-1,w);
   }
   return result;
 }
-void AGG::getKSymPayoffVector(AggNumberVector& dest,int playerClass, StrategyProfile &s){
+void AGG::getKSymPayoffVector(AggNumberVector& dest,int playerClass, const StrategyProfile &s,
+                              Workspace &w) const {
   for (size_t act=0;act<uniqueActionSets[playerClass].size();++act){
-    dest[act]=getKSymMixedPayoff(s,playerClass,act);
+    dest[act]=getKSymMixedPayoff(s,playerClass,act,-1,-1,w);
   }
 }
-AggNumber AGG::getKSymMixedPayoff(int playerClass, int act, vector<StrategyProfile> &s){
+AggNumber AGG::getKSymMixedPayoff(int playerClass, int act, const vector<StrategyProfile> &s,
+                                  Workspace &w) const {
       
       int numPC = playerClasses.size();
       
       int numNei = neighbors[uniqueActionSets[playerClass][act]].size();
 
-      static aggdistrib d,temp;
+      aggdistrib &d = w.d, &temp = w.temp;
       d.reset();
       temp.reset();
-      getSymConfigProb(0, s[0], playerClass, act, d);
+      getSymConfigProb(0, s[0], playerClass, act, d, w);
       for(int pc=1;pc<numPC;pc++){
-	  getSymConfigProb(pc, s[pc], playerClass, act, temp);
+	  getSymConfigProb(pc, s[pc], playerClass, act, temp, w);
 	  d.multiply(temp, numNei, projFunctions[uniqueActionSets[playerClass][act]]);
       }
       return d.inner_prod(payoffs[uniqueActionSets[playerClass][act]]);
 }
 
-AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2){
+AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,int pClass2,int act2,
+                                  Workspace &w) const {
   int numPC=playerClasses.size();
   int numNei=neighbors[uniqueActionSets[pClass1][act1]].size();
-  static aggdistrib d,temp;
+  aggdistrib &d = w.d, &temp = w.temp;
   if (pClass2>=0 && pClass1==pClass2 && playerClasses.at(pClass1).size()<=1){
     return 0;
   }
@@ -949,13 +1301,13 @@ AggNumber AGG::getKSymMixedPayoff(const StrategyProfile &s,int pClass1,int act1,
   //if (0==pClass2) s0[act2]=1;
   //else
   for (int a=firstKSymAction(0);a<lastKSymAction(0);++a)s0[a]=s[a];
-  getSymConfigProb(0,s0,pClass1,act1,d,pClass2,act2);
+  getSymConfigProb(0,s0,pClass1,act1,d,w,pClass2,act2);
   for (int pc=1;pc<numPC;pc++){
     StrategyProfile ss(getNumKSymActions(pc), 0.0);
     //if (pc==pClass2)ss[act2]=1;
     //else
     for (int a=0;a<getNumKSymActions(pc);++a)ss[a]=s[a+firstKSymAction(pc)];
-    getSymConfigProb(pc,ss,pClass1,act1,temp,pClass2,act2);
+    getSymConfigProb(pc,ss,pClass1,act1,temp,w,pClass2,act2);
     d.multiply(temp,numNei,projFunctions[uniqueActionSets[pClass1][act1]]);
   }
   return d.inner_prod(payoffs[uniqueActionSets[pClass1][act1]]);
@@ -1064,29 +1416,20 @@ void AGG::makeMAPPINGpayoff(std::istream& in, aggpayoff& pay, int numNei){
 
 }
 
-AggNumber AGG::getMaxPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
+AggNumber AGG::getMaxPayoff() const {
   assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-    for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
+  AggNumber result=payoffs[0].begin()->second;
+  for (int i=0;i<numActionNodes;i++)
+    for (aggpayoff::const_iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
       result=max(result, it->second);
-
-  done=true;
   return result;
 }
-AggNumber AGG::getMinPayoff(){
-  static bool done=false;
-  static AggNumber result=0;
-  if (done)return result;
+AggNumber AGG::getMinPayoff() const {
   assert(numActionNodes>0);
-  result=payoffs[0].begin()->second;
-  for (int i=1;i<numActionNodes;i++)
-      for (aggpayoff::iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
+  AggNumber result=payoffs[0].begin()->second;
+  for (int i=0;i<numActionNodes;i++)
+      for (aggpayoff::const_iterator it=payoffs[i].begin();it!=payoffs[i].end();++it)
         result=min(result, it->second);
-  done=true;
   return result;
 }
 
@@ -222,26 +222,27 @@ BAGG *BAGG::makeRandomBAGG(int N,vector<int> &numTypes,vector<ProbDist> &TDist,i
   return new BAGG(N,S,numTypes,TDist,typeActionSets, typeAction2ActionIndex, aggPtr);
 }
 
-AggNumber BAGG::getMixedPayoff(int player, StrategyProfile &s){
+AggNumber BAGG::getMixedPayoff(int player, const StrategyProfile &s, Workspace &w){
   AggNumber res(0);
   for (int tp=0;tp<numTypes[player];++tp){
-    res+=indepTypeDist[player][tp] * getMixedPayoff(player,tp,s);
+    res+=indepTypeDist[player][tp] * getMixedPayoff(player,tp,s,w);
   }
   return res;
 }
 
-AggNumber BAGG::getMixedPayoff(int player,int tp, StrategyProfile &s){
+AggNumber BAGG::getMixedPayoff(int player,int tp, const StrategyProfile &s, Workspace &w){
     AggNumber res(0);
     for (size_t act=0;act<typeActionSets[player][tp].size(); ++act)
 	if (s[act+firstAction(player,tp)]>AggNumber(0.0))
-	    res+= s[act+firstAction(player,tp)] * getV(player,tp,act,s);
+	    res+= s[act+firstAction(player,tp)] * getV(player,tp,act,s,w);
     return res;
 }
 
-void BAGG::getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s){
+void BAGG::getPayoffVector(AggNumberVector &dest, int player,int tp, const StrategyProfile &s,
+                           Workspace &w){
     assert(player>=0&&player < getNumPlayers() && tp>=0 && tp<getNumTypes(player));
     for(size_t act=0;act<typeActionSets[player][tp].size(); ++act){
-      dest[act] = getV(player,tp,act,s);
+      dest[act] = getV(player,tp,act,s,w);
     }
 }
 
@@ -264,10 +265,10 @@ void BAGG::getAGGStrat(StrategyProfile &as, const StrategyProfile &s, int player
     }
 
 }
-AggNumber BAGG::getV (int player, int tp, int action,const StrategyProfile &s){
-    StrategyProfile as(aggPtr->getNumActions());
-    getAGGStrat(as, s, player,tp,action);
-    return aggPtr->getV(player, typeAction2ActionIndex[player][tp][action], as);
+AggNumber BAGG::getV (int player, int tp, int action,const StrategyProfile &s, Workspace &w){
+    getAGGStrat(w.aggStrat, s, player,tp,action);
+    return aggPtr->getV(player, typeAction2ActionIndex[player][tp][action], w.aggStrat,
+                        w.aggWorkspace);
 }
 
 AggNumber BAGG::getPurePayoff(int player, int tp, int *ps)
@@ -0,0 +1,618 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: library/src/binfile.cc
+// Reading and writing games in binary savefile format
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+//
+// The binary savefile format holds a table or tree game in fixed-width
+// records, so that a game is loaded without parsing any text.  Fields
+// are written in the byte order of the machine writing the file, which
+// is recorded in the header; a file is only read on a machine with the
+// same byte order.  All records are multiples of eight bytes long, and
+// each section is padded to a multiple of eight bytes, so the records
+// are aligned in a memory-mapped file.
+//
+// A file consists of the following sections, in order:
+//
+// * The header (BinaryHeader), giving the number of each kind of record.
+// * The strings: all labels and payoff texts, each terminated by '\0'.
+//   Strings are referred to by their byte offset in this section; the
+//   section begins with the empty string, at offset zero.
+// * The players (BinaryPlayerRecord).
+// * For tables, the strategies of each player in turn (BinaryLabelRecord).
+// * The outcomes (BinaryLabelRecord), followed by the payoffs of each
+//   outcome in turn (BinaryNumberRecord).  A payoff is held as a
+//   numerator and denominator when these fit in 64 bits, as well as
+//   the text it was specified as.
+// * For tables, the index of the outcome at each contingency, with the
+//   first player's strategy changing most rapidly (uint32_t; 0 for none).
+// * For trees, the information sets (BinaryInfosetRecord), with the
+//   chance player's first, then each player's in turn; then the actions
+//   of each information set in turn (BinaryActionRecord); then the nodes
+//   in preorder (BinaryNodeRecord).  A decision node's children are the
+//   nodes following it in preorder, one for each action at the node.
+//
+
+#include <climits>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+#include "gambit/gambit.h"
+// for explicit access to turning off canonicalization
+#include "gambit/gametree.h"
+
+namespace Gambit {
+
+namespace {
+
+const char c_binaryMagic[8] = { 'G', 'A', 'M', 'B', 'I', 'T', 'B', 'G' };
+const uint32_t c_binaryVersion = 1;
+const uint32_t c_binaryByteOrder = 0x01020304;
+
+enum { BINARY_TABLE = 1, BINARY_TREE = 2 };
+
+struct BinaryHeader {
+  char m_magic[8];
+  uint32_t m_version, m_byteOrder;
+  uint32_t m_gameType, m_numPlayers;
+  uint32_t m_numOutcomes, m_numInfosets;
+  uint32_t m_title, m_comment;
+  uint64_t m_numContingencies, m_numNodes;
+  uint64_t m_stringsSize;
+};
+
+struct BinaryPlayerRecord {
+  uint32_t m_label, m_numStrategies;
+};
+
+struct BinaryLabelRecord {
+  uint32_t m_label, m_reserved;
+};
+
+struct BinaryNumberRecord {
+  /// The value, as numerator and denominator; the denominator is zero
+  /// if the value does not fit, and the value is taken from the text
+  int64_t m_numerator, m_denominator;
+  uint32_t m_text, m_reserved;
+};
+
+struct BinaryInfosetRecord {
+  /// The player, or zero for the chance player
+  uint32_t m_player;
+  uint32_t m_label, m_numActions, m_reserved;
+};
+
+struct BinaryActionRecord {
+  /// The probability of the action, for chance actions only
+  uint32_t m_label, m_prob;
+};
+
+struct BinaryNodeRecord {
+  /// The information set and outcome at the node; zero if none
+  uint32_t m_label, m_infoset, m_outcome, m_reserved;
+};
+
+inline size_t PaddedSize(size_t p_size)
+{ return (p_size + 7) & ~((size_t) 7); }
+
+//=========================================================================
+//                          Writing binary files
+//=========================================================================
+
+//!
+//! Collects the records of a binary savefile.  Identical labels are
+//! stored once; payoff texts, which are mostly distinct in large games,
+//! are stored as they come, which is much quicker than pooling them.
+//!
+class BinaryGameWriter {
+private:
+  std::vector<char> m_strings;
+  std::unordered_map<std::string, uint32_t> m_stringOffsets;
+
+public:
+  BinaryHeader m_header;
+  std::vector<BinaryPlayerRecord> m_players;
+  std::vector<BinaryLabelRecord> m_strategies, m_outcomes;
+  std::vector<BinaryNumberRecord> m_payoffs;
+  std::vector<uint32_t> m_contingencies;
+  std::vector<BinaryInfosetRecord> m_infosets;
+  std::vector<BinaryActionRecord> m_actions;
+  std::vector<BinaryNodeRecord> m_nodes;
+
+  BinaryGameWriter(void);
+
+  /// Returns the offset of the string in the strings section
+  uint32_t AddString(const std::string &, bool p_pool = true);
+  /// Returns the record for the number, from its value and text
+  BinaryNumberRecord AddNumber(const Rational &, const std::string &);
+
+  void Write(std::ostream &);
+};
+
+BinaryGameWriter::BinaryGameWriter(void)
+  : m_strings(1, '\0')
+{
+  memset(&m_header, 0, sizeof(BinaryHeader));
+  memcpy(m_header.m_magic, c_binaryMagic, sizeof(c_binaryMagic));
+  m_header.m_version = c_binaryVersion;
+  m_header.m_byteOrder = c_binaryByteOrder;
+}
+
+uint32_t BinaryGameWriter::AddString(const std::string &p_text, bool p_pool)
+{
+  if (p_text.empty()) {
+    return 0;
+  }
+  if (p_pool) {
+    std::unordered_map<std::string, uint32_t>::const_iterator entry =
+      m_stringOffsets.find(p_text);
+    if (entry != m_stringOffsets.end()) {
+      return entry->second;
+    }
+    m_stringOffsets[p_text] = m_strings.size();
+  }
+  uint32_t offset = m_strings.size();
+  m_strings.insert(m_strings.end(), p_text.c_str(),
+		   p_text.c_str() + p_text.size() + 1);
+  return offset;
+}
+
+BinaryNumberRecord BinaryGameWriter::AddNumber(const Rational &p_value,
+					       const std::string &p_text)
+{
+  BinaryNumberRecord number;
+  memset(&number, 0, sizeof(BinaryNumberRecord));
+  if (p_value.numerator().fits_in_long() &&
+      p_value.denominator().fits_in_long()) {
+    number.m_numerator = p_value.numerator().as_long();
+    number.m_denominator = p_value.denominator().as_long();
+  }
+  number.m_text = AddString(p_text, false);
+  return number;
+}
+
+template <class T> void WriteRecords(std::ostream &p_stream,
+				     const std::vector<T> &p_records)
+{
+  static const char padding[8] = { 0 };
+  size_t size = p_records.size() * sizeof(T);
+  if (size > 0) {
+    p_stream.write(reinterpret_cast<const char *>(&p_records[0]), size);
+    p_stream.write(padding, PaddedSize(size) - size);
+  }
+}
+
+void BinaryGameWriter::Write(std::ostream &p_stream)
+{
+  m_header.m_stringsSize = m_strings.size();
+  p_stream.write(reinterpret_cast<const char *>(&m_header),
+		 sizeof(BinaryHeader));
+  WriteRecords(p_stream, m_strings);
+  WriteRecords(p_stream, m_players);
+  WriteRecords(p_stream, m_strategies);
+  WriteRecords(p_stream, m_outcomes);
+  WriteRecords(p_stream, m_payoffs);
+  WriteRecords(p_stream, m_contingencies);
+  WriteRecords(p_stream, m_infosets);
+  WriteRecords(p_stream, m_actions);
+  WriteRecords(p_stream, m_nodes);
+}
+
+void WriteBinaryNode(BinaryGameWriter &p_writer, const GameNode &p_node,
+		     const Array<uint32_t> &p_infosetOffsets)
+{
+  BinaryNodeRecord node;
+  memset(&node, 0, sizeof(BinaryNodeRecord));
+  node.m_label = p_writer.AddString(p_node->GetLabel());
+  if (p_node->GetInfoset()) {
+    GameInfoset infoset = p_node->GetInfoset();
+    node.m_infoset = (p_infosetOffsets[infoset->GetPlayer()->GetNumber() + 1] +
+		      infoset->GetNumber());
+  }
+  if (p_node->GetOutcome()) {
+    node.m_outcome = p_node->GetOutcome()->GetNumber();
+  }
+  p_writer.m_nodes.push_back(node);
+
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    WriteBinaryNode(p_writer, p_node->GetChild(i), p_infosetOffsets);
+  }
+}
+
+//=========================================================================
+//                          Reading binary files
+//=========================================================================
+
+//!
+//! Reads the records of a binary savefile in turn, checking that they
+//! lie within the file.
+//!
+class BinaryGameReader {
+private:
+  const char *m_pos, *m_end;
+  const char *m_strings;
+  size_t m_stringsSize;
+
+public:
+  BinaryGameReader(const char *p_begin, const char *p_end)
+    : m_pos(p_begin), m_end(p_end), m_strings(0), m_stringsSize(0) { }
+
+  /// Returns a pointer to the next p_count records, and moves past them
+  template <class T> const T *Read(uint64_t p_count);
+  /// Reads the strings section
+  void ReadStrings(uint64_t p_size);
+
+  /// Returns the string at the offset in the strings section
+  const char *GetString(uint32_t p_offset) const;
+  /// Returns the number with the record
+  Number GetNumber(const BinaryNumberRecord &) const;
+};
+
+template <class T> const T *BinaryGameReader::Read(uint64_t p_count)
+{
+  if (p_count > (uint64_t) (m_end - m_pos) / sizeof(T) ||
+      PaddedSize(p_count * sizeof(T)) > (uint64_t) (m_end - m_pos)) {
+    throw InvalidFileException("Binary game file is truncated");
+  }
+  const T *records = reinterpret_cast<const T *>(m_pos);
+  m_pos += PaddedSize(p_count * sizeof(T));
+  return records;
+}
+
+void BinaryGameReader::ReadStrings(uint64_t p_size)
+{
+  m_strings = Read<char>(p_size);
+  m_stringsSize = p_size;
+  if (m_stringsSize == 0 || m_strings[m_stringsSize - 1] != '\0') {
+    throw InvalidFileException("Binary game file has invalid strings");
+  }
+}
+
+const char *BinaryGameReader::GetString(uint32_t p_offset) const
+{
+  if (p_offset >= m_stringsSize) {
+    throw InvalidFileException("Binary game file has invalid string");
+  }
+  return m_strings + p_offset;
+}
+
+Number BinaryGameReader::GetNumber(const BinaryNumberRecord &p_number) const
+{
+  const char *text = GetString(p_number.m_text);
+  if (p_number.m_denominator > 0 &&
+      p_number.m_numerator >= LONG_MIN && p_number.m_numerator <= LONG_MAX &&
+      p_number.m_denominator <= LONG_MAX) {
+    return Number(text, Rational((long) p_number.m_numerator,
+				 (long) p_number.m_denominator));
+  }
+  return Number(text, text + strlen(text));
+}
+
+//!
+//! The information sets and outcomes of a tree being read, for
+//! reference by the nodes
+//!
+class BinaryTreeData {
+public:
+  const BinaryInfosetRecord *m_infosetRecords;
+  Array<const BinaryActionRecord *> m_actionRecords;
+  Array<GameInfoset> m_infosets;
+  Array<GameOutcome> m_outcomes;
+  const BinaryNodeRecord *m_nodeRecords;
+  uint64_t m_numNodes, m_nextNode;
+};
+
+void ReadBinaryNode(const BinaryGameReader &p_reader, Game p_game,
+		    GameNode p_node, BinaryTreeData &p_data)
+{
+  if (p_data.m_nextNode >= p_data.m_numNodes) {
+    throw InvalidFileException("Binary game file has too few nodes");
+  }
+  const BinaryNodeRecord &node = p_data.m_nodeRecords[p_data.m_nextNode++];
+  p_node->SetLabel(p_reader.GetString(node.m_label));
+
+  if (node.m_outcome > 0) {
+    if (node.m_outcome > (uint32_t) p_data.m_outcomes.Length()) {
+      throw InvalidFileException("Binary game file has invalid outcome");
+    }
+    p_node->SetOutcome(p_data.m_outcomes[node.m_outcome]);
+  }
+
+  if (node.m_infoset == 0) {
+    return;
+  }
+  if (node.m_infoset > (uint32_t) p_data.m_infosets.Length()) {
+    throw InvalidFileException("Binary game file has invalid information set");
+  }
+  GameInfoset &infoset = p_data.m_infosets[node.m_infoset];
+  if (infoset) {
+    p_node->AppendMove(infoset);
+  }
+  else {
+    const BinaryInfosetRecord &record = p_data.m_infosetRecords[node.m_infoset - 1];
+    const BinaryActionRecord *actions = p_data.m_actionRecords[node.m_infoset];
+    GamePlayer player = ((record.m_player == 0) ? p_game->GetChance() :
+			 p_game->GetPlayer(record.m_player));
+    infoset = p_node->AppendMove(player, record.m_numActions);
+    infoset->SetLabel(p_reader.GetString(record.m_label));
+    for (int act = 1; act <= infoset->NumActions(); act++) {
+      infoset->GetAction(act)->SetLabel(p_reader.GetString(actions[act - 1].m_label));
+      if (record.m_player == 0) {
+	infoset->SetActionProb(act, p_reader.GetString(actions[act - 1].m_prob));
+      }
+    }
+  }
+
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    ReadBinaryNode(p_reader, p_game, p_node->GetChild(i), p_data);
+  }
+}
+
+Game ReadBinaryTable(BinaryGameReader &p_reader, const BinaryHeader &p_header,
+		     const BinaryPlayerRecord *p_players)
+{
+  Array<int> dim(p_header.m_numPlayers);
+  uint64_t numStrategies = 0, numContingencies = 1;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    dim[pl] = p_players[pl - 1].m_numStrategies;
+    if (dim[pl] <= 0 || numContingencies * dim[pl] > (uint64_t) INT_MAX) {
+      throw InvalidFileException("Binary game file has invalid dimensions");
+    }
+    numStrategies += dim[pl];
+    numContingencies *= dim[pl];
+  }
+  if (numContingencies != p_header.m_numContingencies) {
+    throw InvalidFileException("Binary game file has invalid dimensions");
+  }
+  const BinaryLabelRecord *strategies = p_reader.Read<BinaryLabelRecord>(numStrategies);
+  const BinaryLabelRecord *outcomes = p_reader.Read<BinaryLabelRecord>(p_header.m_numOutcomes);
+  const BinaryNumberRecord *payoffs =
+    p_reader.Read<BinaryNumberRecord>((uint64_t) p_header.m_numOutcomes * dim.Length());
+  const uint32_t *contingencies = p_reader.Read<uint32_t>(numContingencies);
+
+  // When each contingency has its own outcome, in order, as in a newly
+  // created table, the outcomes of the new table are used as they are
+  bool dense = (p_header.m_numOutcomes == numContingencies);
+  for (uint64_t cont = 0; dense && cont < numContingencies; cont++) {
+    dense = (contingencies[cont] == cont + 1);
+  }
+
+  Game game = NewTable(dim, !dense);
+  game->SetTitle(p_reader.GetString(p_header.m_title));
+  game->SetComment(p_reader.GetString(p_header.m_comment));
+  for (int pl = 1, index = 0; pl <= dim.Length(); pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    player->SetLabel(p_reader.GetString(p_players[pl - 1].m_label));
+    for (int st = 1; st <= dim[pl]; st++) {
+      player->GetStrategy(st)->SetLabel(p_reader.GetString(strategies[index++].m_label));
+    }
+  }
+
+  for (uint32_t i = 1; i <= p_header.m_numOutcomes; i++) {
+    GameOutcome outcome = (dense) ? game->GetOutcome(i) : game->NewOutcome();
+    outcome->SetLabel(p_reader.GetString(outcomes[i - 1].m_label));
+    for (int pl = 1; pl <= dim.Length(); pl++) {
+      outcome->SetPayoff(pl, p_reader.GetNumber(*payoffs++));
+    }
+  }
+
+  if (!dense) {
+    StrategySupportProfile support(game);
+    StrategyProfileIterator iter(support);
+    for (uint64_t cont = 0; cont < numContingencies; cont++, iter++) {
+      if (contingencies[cont] > p_header.m_numOutcomes) {
+	throw InvalidFileException("Binary game file has invalid outcome");
+      }
+      if (contingencies[cont] > 0) {
+	(*iter)->SetOutcome(game->GetOutcome(contingencies[cont]));
+      }
+    }
+  }
+  return game;
+}
+
+Game ReadBinaryTree(BinaryGameReader &p_reader, const BinaryHeader &p_header,
+		    const BinaryPlayerRecord *p_players)
+{
+  const BinaryLabelRecord *outcomes = p_reader.Read<BinaryLabelRecord>(p_header.m_numOutcomes);
+  const BinaryNumberRecord *payoffs =
+    p_reader.Read<BinaryNumberRecord>((uint64_t) p_header.m_numOutcomes * p_header.m_numPlayers);
+
+  BinaryTreeData data;
+  data.m_infosetRecords = p_reader.Read<BinaryInfosetRecord>(p_header.m_numInfosets);
+  uint64_t numActions = 0;
+  for (uint32_t i = 0; i < p_header.m_numInfosets; i++) {
+    const BinaryInfosetRecord &record = data.m_infosetRecords[i];
+    if (record.m_player > p_header.m_numPlayers ||
+	record.m_numActions == 0 || record.m_numActions > (uint32_t) INT_MAX) {
+      throw InvalidFileException("Binary game file has invalid information set");
+    }
+    numActions += record.m_numActions;
+  }
+  const BinaryActionRecord *actions = p_reader.Read<BinaryActionRecord>(numActions);
+  data.m_actionRecords = Array<const BinaryActionRecord *>(p_header.m_numInfosets);
+  for (uint32_t i = 0; i < p_header.m_numInfosets; i++) {
+    data.m_actionRecords[i + 1] = actions;
+    actions += data.m_infosetRecords[i].m_numActions;
+  }
+  data.m_infosets = Array<GameInfoset>(p_header.m_numInfosets);
+  data.m_nodeRecords = p_reader.Read<BinaryNodeRecord>(p_header.m_numNodes);
+  data.m_numNodes = p_header.m_numNodes;
+  data.m_nextNode = 0;
+
+  Game game = NewTree();
+  dynamic_cast<GameTreeRep &>(*game).SetCanonicalization(false);
+  game->SetTitle(p_reader.GetString(p_header.m_title));
+  game->SetComment(p_reader.GetString(p_header.m_comment));
+  for (uint32_t pl = 0; pl < p_header.m_numPlayers; pl++) {
+    game->NewPlayer()->SetLabel(p_reader.GetString(p_players[pl].m_label));
+  }
+
+  data.m_outcomes = Array<GameOutcome>(p_header.m_numOutcomes);
+  for (uint32_t i = 1; i <= p_header.m_numOutcomes; i++) {
+    GameOutcome outcome = game->NewOutcome();
+    outcome->SetLabel(p_reader.GetString(outcomes[i - 1].m_label));
+    for (uint32_t pl = 1; pl <= p_header.m_numPlayers; pl++) {
+      outcome->SetPayoff(pl, p_reader.GetNumber(*payoffs++));
+    }
+    data.m_outcomes[i] = outcome;
+  }
+
+  ReadBinaryNode(p_reader, game, game->GetRoot(), data);
+  if (data.m_nextNode != data.m_numNodes) {
+    throw InvalidFileException("Binary game file has too many nodes");
+  }
+  dynamic_cast<GameTreeRep &>(*game).SetCanonicalization(true);
+  return game;
+}
+
+}  // end anonymous namespace
+
+//=========================================================================
+//                Writing binary files: GameExplicitRep
+//=========================================================================
+
+void GameExplicitRep::WriteBinaryFile(std::ostream &p_stream) const
+{
+  BinaryGameWriter writer;
+  BinaryHeader &header = writer.m_header;
+  header.m_gameType = (IsTree()) ? BINARY_TREE : BINARY_TABLE;
+  header.m_numPlayers = NumPlayers();
+  header.m_numOutcomes = NumOutcomes();
+  header.m_title = writer.AddString(GetTitle());
+  header.m_comment = writer.AddString(GetComment());
+
+  for (int pl = 1; pl <= NumPlayers(); pl++) {
+    GamePlayer player = GetPlayer(pl);
+    BinaryPlayerRecord record;
+    record.m_label = writer.AddString(player->GetLabel());
+    record.m_numStrategies = (IsTree()) ? 0 : player->NumStrategies();
+    writer.m_players.push_back(record);
+    for (int st = 1; !IsTree() && st <= player->NumStrategies(); st++) {
+      BinaryLabelRecord strategy = { writer.AddString(player->GetStrategy(st)->GetLabel()), 0 };
+      writer.m_strategies.push_back(strategy);
+    }
+  }
+
+  for (int i = 1; i <= NumOutcomes(); i++) {
+    GameOutcome outcome = GetOutcome(i);
+    BinaryLabelRecord record = { writer.AddString(outcome->GetLabel()), 0 };
+    writer.m_outcomes.push_back(record);
+    for (int pl = 1; pl <= NumPlayers(); pl++) {
+      writer.m_payoffs.push_back(writer.AddNumber(outcome->GetPayoff<Rational>(pl),
+						  outcome->GetPayoff<std::string>(pl)));
+    }
+  }
+
+  if (!IsTree()) {
+    for (StrategyProfileIterator iter(StrategySupportProfile(const_cast<GameExplicitRep *>(this)));
+	 !iter.AtEnd(); iter++) {
+      GameOutcome outcome = (*iter)->GetOutcome();
+      writer.m_contingencies.push_back((outcome) ? outcome->GetNumber() : 0);
+    }
+    header.m_numContingencies = writer.m_contingencies.size();
+  }
+  else {
+    // Information sets are numbered consecutively, the chance player's
+    // first; p_infosetOffsets[pl + 1] is the number before player pl's first
+    Array<uint32_t> infosetOffsets(NumPlayers() + 1);
+    for (int pl = 0; pl <= NumPlayers(); pl++) {
+      GamePlayer player = (pl == 0) ? GetChance() : GetPlayer(pl);
+      infosetOffsets[pl + 1] = writer.m_infosets.size();
+      for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+	GameInfoset infoset = player->GetInfoset(iset);
+	BinaryInfosetRecord record;
+	record.m_player = pl;
+	record.m_label = writer.AddString(infoset->GetLabel());
+	record.m_numActions = infoset->NumActions();
+	record.m_reserved = 0;
+	writer.m_infosets.push_back(record);
+	for (int act = 1; act <= infoset->NumActions(); act++) {
+	  BinaryActionRecord action;
+	  action.m_label = writer.AddString(infoset->GetAction(act)->GetLabel());
+	  action.m_prob = ((pl == 0) ?
+			   writer.AddString(infoset->GetActionProb(act, "")) : 0);
+	  writer.m_actions.push_back(action);
+	}
+      }
+    }
+    header.m_numInfosets = writer.m_infosets.size();
+    WriteBinaryNode(writer, GetRoot(), infosetOffsets);
+    header.m_numNodes = writer.m_nodes.size();
+  }
+
+  writer.Write(p_stream);
+}
+
+//=========================================================================
+//                          Reading binary files
+//=========================================================================
+
+bool IsBinaryGame(const char *p_begin, const char *p_end)
+{
+  return (p_end - p_begin >= (ptrdiff_t) sizeof(c_binaryMagic) &&
+	  !memcmp(p_begin, c_binaryMagic, sizeof(c_binaryMagic)));
+}
+
+Game ReadBinaryGame(const char *p_begin, const char *p_end)
+  throw (InvalidFileException)
+{
+  try {
+    BinaryGameReader reader(p_begin, p_end);
+    const BinaryHeader &header = *reader.Read<BinaryHeader>(1);
+    if (memcmp(header.m_magic, c_binaryMagic, sizeof(c_binaryMagic))) {
+      throw InvalidFileException("Not a binary game file");
+    }
+    if (header.m_byteOrder != c_binaryByteOrder) {
+      throw InvalidFileException("Binary game file was written with a different byte order");
+    }
+    if (header.m_version != c_binaryVersion) {
+      throw InvalidFileException("Unsupported version of binary game file");
+    }
+    if (header.m_numPlayers > (uint32_t) INT_MAX ||
+        header.m_numOutcomes > (uint32_t) INT_MAX ||
+        header.m_numInfosets > (uint32_t) INT_MAX) {
+      throw InvalidFileException("Binary game file has invalid dimensions");
+    }
+
+    reader.ReadStrings(header.m_stringsSize);
+    const BinaryPlayerRecord *players = reader.Read<BinaryPlayerRecord>(header.m_numPlayers);
+    if (header.m_gameType == BINARY_TABLE) {
+      return ReadBinaryTable(reader, header, players);
+    }
+    else if (header.m_gameType == BINARY_TREE) {
+      return ReadBinaryTree(reader, header, players);
+    }
+    else {
+      throw InvalidFileException("Binary game file has unknown game type");
+    }
+  }
+  catch (InvalidFileException &) {
+    throw;
+  }
+  catch (std::exception &ex) {
+    // For example, a payoff whose text is not a number
+    throw InvalidFileException(ex.what());
+  }
+}
+
+}  // end namespace Gambit
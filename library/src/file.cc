@@ -22,13 +22,23 @@
 
 #include <cstdlib>
 #include <cctype>
+#include <cstring>
 #include <iostream>
+#include <fstream>
 #include <sstream>
+#include <vector>
 #include <map>
 
 #include "gambit/gambit.h"
 // for explicit access to turning off canonicalization
 #include "gambit/gametree.h"
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif  // HAVE_MMAP && HAVE_SYS_MMAN_H
   
 
 namespace {
@@ -46,40 +56,75 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! The parser works directly on the characters of the file, held
+//! contiguously in memory.  Numbers are not copied out of the file;
+//! GetLastNumber() converts the text of the last number read in place.
+//! Reading past the end of the text sets end-of-file and failure
+//! states in the same way as reading from a std::istream does, so that
+//! the line and column positions reported in error messages are
+//! those of the stream-based parser.
+//!
 class GameParserState {
 private:
-  std::istream &m_file;
+  const char *m_pos, *m_end;
+  bool m_eof, m_fail;
 
   int m_currentLine;
   int m_currentColumn;
   GameFileToken m_lastToken;
-  std::string m_lastText;
+  const char *m_tokenBegin, *m_tokenEnd;
+  // The text of the last number, label or symbol read; for a number
+  // this is only copied out of [m_tokenBegin, m_tokenEnd) on request
+  mutable std::string m_lastText;
+  bool m_lastTextIsNumber;
 
   void ReadChar(char& c);
   void UnreadChar(void);
   void IncreaseLine(void);
+  bool Good(void) const { return !m_eof && !m_fail; }
 
 public:
-  GameParserState(std::istream &p_file) :
-    m_file(p_file), m_currentLine(1), m_currentColumn(1) { }
+  GameParserState(const char *p_begin, const char *p_end) :
+    m_pos(p_begin), m_end(p_end), m_eof(false), m_fail(false),
+    m_currentLine(1), m_currentColumn(1),
+    m_tokenBegin(p_begin), m_tokenEnd(p_begin), m_lastTextIsNumber(false) { }
 
   GameFileToken GetNextToken(void);
   GameFileToken GetCurrentToken(void) const { return m_lastToken; }
   int GetCurrentLine(void) const { return m_currentLine; }
   int GetCurrentColumn(void) const { return m_currentColumn; }
   std::string CreateLineMsg(const std::string &msg);
-  const std::string &GetLastText(void) const { return m_lastText; }
+  const std::string &GetLastText(void) const;
+  /// Returns the last number read as an integer, ignoring any fractional
+  /// part, in the manner of atoi()
+  int GetLastInteger(void) const;
+  /// Returns the last number read
+  Number GetLastNumber(void) const { return Number(m_tokenBegin, m_tokenEnd); }
+  /// Returns the position just after the last token read
+  const char *GetPosition(void) const { return m_pos; }
 };
 
-void GameParserState::ReadChar(char& c)
+inline void GameParserState::ReadChar(char& c)
 {
-  m_file.get(c);
+  if (Good() && m_pos < m_end) {
+    c = *m_pos++;
+  }
+  else {
+    if (Good()) {
+      m_eof = true;
+    }
+    m_fail = true;
+    c = '\0';
+  }
   m_currentColumn++;
 }
 
-void GameParserState::UnreadChar(void)
+inline void GameParserState::UnreadChar(void)
 {
-  m_file.unget();
+  m_eof = false;
+  if (!m_fail) {
+    m_pos--;
+  }
   m_currentColumn--;
 }
 
@@ -89,16 +134,38 @@ void GameParserState::IncreaseLine(void){
   m_currentColumn = 1;
 }
 
+const std::string &GameParserState::GetLastText(void) const
+{
+  if (m_lastTextIsNumber) {
+    m_lastText.assign(m_tokenBegin, m_tokenEnd);
+  }
+  return m_lastText;
+}
+
+int GameParserState::GetLastInteger(void) const
+{
+  const char *pos = m_tokenBegin;
+  bool negative = false;
+  if (pos < m_tokenEnd && (*pos == '-' || *pos == '+')) {
+    negative = (*pos++ == '-');
+  }
+  int value = 0;
+  while (pos < m_tokenEnd && isdigit(*pos)) {
+    value = 10 * value + (*pos++ - '0');
+  }
+  return (negative) ? -value : value;
+}
+
 GameFileToken GameParserState::GetNextToken(void)
 {
   char c = ' ';
-  if (m_file.eof()) {
+  if (m_eof) {
     return (m_lastToken = TOKEN_EOF);
   }
 
   while (isspace(c)) {
     ReadChar(c);
-    if (!m_file.good()) {
+    if (!Good()) {
       return (m_lastToken = TOKEN_EOF);
     }
     else if (c == '\n') {
@@ -116,91 +183,67 @@ GameFileToken GameParserState::GetNextToken(void)
     return (m_lastToken = TOKEN_COMMA);
   }
   else if (isdigit(c) || c == '-' || c == '+') {
-    std::string buf;
-    buf += c;
+    m_tokenBegin = m_pos - 1;
     ReadChar(c);
 
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
-      buf += c;
+    while (Good() && isdigit(c)) {
       ReadChar(c);
     }
 
-    if (m_file.eof() || !m_file.good()) {
-      m_lastText = buf;
+    if (!Good()) {
+      m_tokenEnd = m_pos;
+      m_lastTextIsNumber = true;
       return (m_lastToken = TOKEN_NUMBER);
     }
 
     if (c == '.') {
-      buf += c;
       ReadChar(c);
       while (isdigit(c)) {
-        buf += c;
         ReadChar(c);
       }
 
       if (c == 'e' || c == 'E') {
-        buf += c;
         ReadChar(c);
         if (c != '+' && c != '-' && !isdigit(c)) {
           throw InvalidFileException(CreateLineMsg("Invalid Token +/-"));
         }
-        buf += c;
         ReadChar(c);
         while (isdigit(c)) {
-          buf += c;
           ReadChar(c);
         }
       }
-
-      UnreadChar();
-      m_lastText = buf;
-
-      return (m_lastToken = TOKEN_NUMBER);
     }
     else if (c == '/') {
-      buf += c;
       ReadChar(c);
       while (isdigit(c)) {
-        buf += c;
         ReadChar(c);
       }
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
     }
     else if (c == 'e' || c == 'E') {
-      buf += c;
       ReadChar(c);
       if (c != '+' && c != '-' && !isdigit(c)) {
         throw InvalidFileException(CreateLineMsg("Invalid Token +/-"));
       }
-      buf += c;
       ReadChar(c);
       while (isdigit(c)) {
-        buf += c;
         ReadChar(c);
       }
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else {
-      UnreadChar();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
     }
+    UnreadChar();
+    m_tokenEnd = m_pos;
+    m_lastTextIsNumber = true;
+    return (m_lastToken = TOKEN_NUMBER);
   }
   else if (c == '.') {
-    std::string buf;
-    buf += c;
+    m_tokenBegin = m_pos - 1;
     ReadChar(c);
 
     while (isdigit(c)) {
-      buf += c;
       ReadChar(c);
     }
     UnreadChar();
-    m_lastText = buf;
+    m_tokenEnd = m_pos;
+    m_lastTextIsNumber = true;
     return (m_lastToken = TOKEN_NUMBER);
   }
 
@@ -210,7 +253,8 @@ GameFileToken GameParserState::GetNextToken(void)
     UnreadChar();
     char a;
 
-    m_lastText = "";
+    m_lastText.clear();
+    m_lastTextIsNumber = false;
 
     do  {
       ReadChar(a);
@@ -224,7 +268,7 @@ GameFileToken GameParserState::GetNextToken(void)
 
       ReadChar(a);
       while  (a != '\"' || lastslash)  {
-	if (m_file.eof() || !m_file.good())  {
+	if (!Good())  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (lastslash && a == '"') {
@@ -245,7 +289,7 @@ GameFileToken GameParserState::GetNextToken(void)
       do  {
       	m_lastText += a;
         ReadChar(a);
-	if (m_file.eof() || !m_file.good())  {
+	if (!Good())  {
 	  throw InvalidFileException(CreateLineMsg("End of file encountered when reading string label"));
 	}
         if (a == '\n') {
@@ -257,8 +301,9 @@ GameFileToken GameParserState::GetNextToken(void)
     return (m_lastToken = TOKEN_TEXT);
   }
 
-  m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
+  m_lastText.clear();
+  m_lastTextIsNumber = false;
+  while (!isspace(c) && !m_eof) {
     m_lastText += c;
     ReadChar(c);
   }
@@ -457,7 +502,7 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
           "Not enough players for number of strategy entries"));
       }
 
-      for (int st = 1; st <= atoi(p_state.GetLastText().c_str()); st++) {
+      for (int st = 1; st <= p_state.GetLastInteger(); st++) {
         player->m_strategies.Append(lexical_cast<std::string>(st));
       }
 
@@ -549,18 +594,15 @@ void ReadOutcomeList(GameParserState &p_parser, GameRep *p_nfg)
     outcome->SetLabel(p_parser.GetLastText());
     p_parser.GetNextToken();
 
-    try {
-      while (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-        outcome->SetPayoff(pl++, p_parser.GetLastText());
-        if (p_parser.GetNextToken() == TOKEN_COMMA) {
-            p_parser.GetNextToken();
-        }
+    while (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
+      if (pl > p_nfg->NumPlayers()) {
+        throw InvalidFileException(
+          p_parser.CreateLineMsg("Exceeded number of players in outcome"));
+      }
+      outcome->SetPayoff(pl++, p_parser.GetLastNumber());
+      if (p_parser.GetNextToken() == TOKEN_COMMA) {
+        p_parser.GetNextToken();
       }
-    }
-    catch (IndexException &) {
-      // This would be triggered by too many payoffs
-      throw InvalidFileException(
-        p_parser.CreateLineMsg("Exceeded number of players in outcome"));
     }
 
     if (pl <= p_nfg->NumPlayers() ||
@@ -591,7 +633,7 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
         p_parser.CreateLineMsg("Expecting outcome index"));
     }
 
-    int outcomeId = atoi(p_parser.GetLastText().c_str());
+    int outcomeId = p_parser.GetLastInteger();
     if (outcomeId > 0)  {
       (*iter)->SetOutcome(p_nfg->GetOutcome(outcomeId));
     }
@@ -605,19 +647,23 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
 
 void ParsePayoffBody(GameParserState &p_parser, GameRep *p_nfg)
 {
-  StrategyProfileIterator iter(StrategySupportProfile(static_cast<GameRep *>(p_nfg)));
-  int pl = 1;
+  // A newly-created table has one outcome for each contingency, in the
+  // order in which payoffs are listed (first player's strategy changing
+  // most rapidly), so each payoff is set directly on its outcome.
+  int numPlayers = p_nfg->NumPlayers(), numOutcomes = p_nfg->NumOutcomes();
+  int cont = 1, pl = 1;
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
-    if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, p_parser.GetLastText());
-    }
-    else {
+    if (p_parser.GetCurrentToken() != TOKEN_NUMBER) {
       throw InvalidFileException(p_parser.CreateLineMsg("Expecting payoff"));
     }
+    if (cont > numOutcomes) {
+      throw InvalidFileException(p_parser.CreateLineMsg("Too many payoffs"));
+    }
+    p_nfg->GetOutcome(cont)->SetPayoff(pl, p_parser.GetLastNumber());
 
-    if (++pl > p_nfg->NumPlayers()) {
-      iter++;
+    if (++pl > numPlayers) {
+      cont++;
       pl = 1;
     }
     p_parser.GetNextToken();
@@ -712,7 +758,7 @@ void ParseOutcome(GameParserState &p_state,
       p_state.CreateLineMsg("Expecting index of outcome"));
   }
 
-  int outcomeId = atoi(p_state.GetLastText().c_str());
+  int outcomeId = p_state.GetLastInteger();
   p_state.GetNextToken();
 
   if (p_state.GetCurrentToken() == TOKEN_TEXT) {
@@ -737,7 +783,7 @@ void ParseOutcome(GameParserState &p_state,
 
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
       if (p_state.GetCurrentToken() == TOKEN_NUMBER) {
-        outcome->SetPayoff(pl, p_state.GetLastText());
+        outcome->SetPayoff(pl, p_state.GetLastNumber());
       }
       else {
         throw InvalidFileException(
@@ -791,7 +837,7 @@ void ParseChanceNode(GameParserState &p_state,
     throw InvalidFileException(p_state.CreateLineMsg("Expecting infoset id"));
   }
 
-  int infosetId = atoi(p_state.GetLastText().c_str());
+  int infosetId = p_state.GetLastInteger();
   GameInfoset infoset;
   if (p_treeData.m_chanceInfosetMap.count(infosetId)) {
     infoset = p_treeData.m_chanceInfosetMap[infosetId];
@@ -869,7 +915,7 @@ void ParsePersonalNode(GameParserState &p_state,
   if (p_state.GetNextToken() != TOKEN_NUMBER) {
     throw InvalidFileException(p_state.CreateLineMsg("Expecting player id"));
   }
-  int playerId = atoi(p_state.GetLastText().c_str());
+  int playerId = p_state.GetLastInteger();
   // This will throw an exception if the player ID is not valid
   GamePlayer player = p_game->GetPlayer(playerId);
   std::map<int, GameInfoset> &infosetMap = p_treeData.m_infosetMap[playerId];
@@ -877,7 +923,7 @@ void ParsePersonalNode(GameParserState &p_state,
   if (p_state.GetNextToken() != TOKEN_NUMBER) {
     throw InvalidFileException(p_state.CreateLineMsg("Expecting infoset id"));
   }
-  int infosetId = atoi(p_state.GetLastText().c_str());
+  int infosetId = p_state.GetLastInteger();
   GameInfoset infoset;
   if (infosetMap.count(infosetId)) {
     infoset = infosetMap[infosetId];
@@ -1048,23 +1094,133 @@ Game GameXMLSavefile::GetGame(void) const
 }
 
 //=========================================================================
-//    ReadGame: Global visible function to read an .efg or .nfg file
+//          Holding the contents of a savefile for parsing
 //=========================================================================
 
-Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+namespace {
+
+//!
+//! The contents of a savefile, held contiguously in memory for parsing.
+//! Files are memory-mapped where the platform supports it; otherwise,
+//! and for streams, the contents are read in large blocks.
+//!
+class GameFileBuffer {
+private:
+  std::vector<char> m_data;
+  void *m_map;
+  size_t m_mapLength;
+
+  void Read(std::istream &p_file);
+
+  GameFileBuffer(const GameFileBuffer &);
+  GameFileBuffer &operator=(const GameFileBuffer &);
+
+public:
+  explicit GameFileBuffer(std::istream &p_file);
+  explicit GameFileBuffer(const std::string &p_filename);
+  ~GameFileBuffer();
+
+  const char *Begin(void) const
+  { return (m_map) ? static_cast<const char *>(m_map) : m_data.data(); }
+  const char *End(void) const
+  { return (m_map) ? Begin() + m_mapLength : m_data.data() + m_data.size(); }
+};
+
+GameFileBuffer::GameFileBuffer(std::istream &p_file)
+  : m_map(0), m_mapLength(0)
 {
-  std::stringstream buffer;
-  buffer << p_file.rdbuf();
-  try {
-    GameXMLSavefile doc(buffer.str());
-    return doc.GetGame();
+  Read(p_file);
+}
+
+GameFileBuffer::GameFileBuffer(const std::string &p_filename)
+  : m_map(0), m_mapLength(0)
+{
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+  int fd = open(p_filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      void *map = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+	m_map = map;
+	m_mapLength = info.st_size;
+      }
+    }
+    close(fd);
+    if (m_map) {
+      return;
+    }
+  }
+#endif  // HAVE_MMAP && HAVE_SYS_MMAN_H
+
+  std::ifstream file(p_filename.c_str());
+  if (!file.is_open()) {
+    throw InvalidFileException("Unable to open file " + p_filename);
+  }
+  Read(file);
+}
+
+GameFileBuffer::~GameFileBuffer()
+{
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+  if (m_map) {
+    munmap(m_map, m_mapLength);
+  }
+#endif  // HAVE_MMAP && HAVE_SYS_MMAN_H
+}
+
+void GameFileBuffer::Read(std::istream &p_file)
+{
+  const std::streamsize blockSize = 1 << 20;
+  std::streambuf *buffer = p_file.rdbuf();
+  std::streamsize count = (buffer) ? blockSize : 0;
+  while (count > 0) {
+    size_t size = m_data.size();
+    m_data.resize(size + blockSize);
+    count = buffer->sgetn(&m_data[size], blockSize);
+    m_data.resize(size + count);
+  }
+}
+
+//!
+//! A read-only stream buffer over characters held in memory, for
+//! passing the remainder of a savefile to readers taking a stream
+//!
+class GameFileStreamBuf : public std::streambuf {
+public:
+  GameFileStreamBuf(const char *p_begin, const char *p_end)
+  {
+    setg(const_cast<char *>(p_begin), const_cast<char *>(p_begin),
+	 const_cast<char *>(p_end));
+  }
+};
+
+Game ParseGameText(const char *p_begin, const char *p_end)
+{
+  // Only an XML document can begin with '<' (after any whitespace or
+  // byte-order mark); binary files begin with their own signature, and
+  // any other format is identified by its first token
+  const char *start = p_begin;
+  if (p_end - start >= 3 && !strncmp(start, "\xEF\xBB\xBF", 3)) {
+    start += 3;
+  }
+  while (start < p_end && isspace(*start)) {
+    start++;
   }
-  catch (InvalidFileException) {
-    buffer.seekg(0, std::ios::beg);
+  if (start < p_end && *start == '<') {
+    try {
+      GameXMLSavefile doc(std::string(p_begin, p_end));
+      return doc.GetGame();
+    }
+    catch (InvalidFileException &) { }
   }
 
-  GameParserState parser(buffer);
+  GameParserState parser(p_begin, p_end);
   try {
+    if (IsBinaryGame(p_begin, p_end)) {
+      return ReadBinaryGame(p_begin, p_end);
+    }
+
     if (parser.GetNextToken() != TOKEN_SYMBOL) {
       throw InvalidFileException(parser.CreateLineMsg("Expecting file type"));
     }
@@ -1083,10 +1239,14 @@ Game ReadGame(std::istream &p_file) throw (InvalidFileException)
       return game;
     }
     else if (parser.GetLastText() == "#AGG") {
-      return GameAggRep::ReadAggFile(buffer);
+      GameFileStreamBuf buffer(parser.GetPosition(), p_end);
+      std::istream stream(&buffer);
+      return GameAggRep::ReadAggFile(stream);
     }
     else if (parser.GetLastText() == "#BAGG") {
-      return GameBagentRep::ReadBaggFile(buffer);
+      GameFileStreamBuf buffer(parser.GetPosition(), p_end);
+      std::istream stream(&buffer);
+      return GameBagentRep::ReadBaggFile(stream);
     }
     else {
       throw InvalidFileException("Tokens 'EFG' or 'NFG' or '#AGG' or '#BAGG' expected at start of file");
@@ -1097,4 +1257,22 @@ Game ReadGame(std::istream &p_file) throw (InvalidFileException)
   }
 }
 
+}  // end anonymous namespace
+
+//=========================================================================
+//    ReadGame: Global visible function to read an .efg or .nfg file
+//=========================================================================
+
+Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+{
+  GameFileBuffer buffer(p_file);
+  return ParseGameText(buffer.Begin(), buffer.End());
+}
+
+Game ReadGameFile(const std::string &p_filename) throw (InvalidFileException)
+{
+  GameFileBuffer buffer(p_filename);
+  return ParseGameText(buffer.Begin(), buffer.End());
+}
+
 } // end namespace Gambit
@@ -87,7 +87,9 @@ GameOutcome TablePureStrategyProfileRep::GetOutcome(void) const
 
 void TablePureStrategyProfileRep::SetOutcome(GameOutcome p_outcome)
 {
-  dynamic_cast<GameTableRep &>(*m_nfg).m_results[m_index] = p_outcome; 
+  GameTableRep &game = dynamic_cast<GameTableRep &>(*m_nfg);
+  game.m_results[m_index] = p_outcome; 
+  game.ClearComputedPayoffs();
 }
 
 Rational TablePureStrategyProfileRep::GetPayoff(int pl) const
@@ -140,6 +142,7 @@ int Product(const Array<int> &dim)
   
 GameTableRep::GameTableRep(const Array<int> &dim, 
 			   bool p_sparseOutcomes /* = false */)
+  : m_hasDoublePayoffs(false), m_hasRationalPayoffs(false)
 {
   m_results = Array<GameOutcomeRep *>(Product(dim));
   for (int pl = 1; pl <= dim.Length(); pl++)  {
@@ -166,10 +169,39 @@ GameTableRep::GameTableRep(const Array<int> &dim,
 
 Game GameTableRep::Copy(void) const
 {
-  std::ostringstream os;
-  WriteNfgFile(os);
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  // The copy is built directly from this game's objects; payoffs are
+  // copied as Numbers, so no text is written out or parsed again.
+  Array<int> dim(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    dim[pl] = m_players[pl]->m_strategies.Length();
+  }
+  GameTableRep *nfg = new GameTableRep(dim, true);
+  Game game = nfg;
+  nfg->m_title = m_title;
+  nfg->m_comment = m_comment;
+
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    nfg->m_players[pl]->m_label = m_players[pl]->m_label;
+    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); st++) {
+      nfg->m_players[pl]->m_strategies[st]->m_label =
+	m_players[pl]->m_strategies[st]->m_label;
+    }
+  }
+
+  nfg->m_outcomes = Array<GameOutcomeRep *>(m_outcomes.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = new GameOutcomeRep(nfg, outc);
+    outcome->m_label = m_outcomes[outc]->m_label;
+    outcome->m_payoffs = m_outcomes[outc]->m_payoffs;
+    nfg->m_outcomes[outc] = outcome;
+  }
+
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    if (m_results[cont]) {
+      nfg->m_results[cont] = nfg->m_outcomes[m_results[cont]->m_number];
+    }
+  }
+  return game;
 }
 
 //------------------------------------------------------------------------
@@ -200,6 +232,35 @@ bool GameTableRep::IsConstSum(void) const
   return true;
 }
 
+//------------------------------------------------------------------------
+//                  GameTableRep: Dense payoff tables
+//------------------------------------------------------------------------
+
+const Array<double> &GameTableRep::GetPayoffTable(int pl, double) const
+{
+  if (!m_hasDoublePayoffs) {
+    std::lock_guard<std::mutex> lock(m_payoffsMutex);
+    if (!m_hasDoublePayoffs) {
+      BuildPayoffTable(m_doublePayoffs);
+      m_hasDoublePayoffs = true;
+    }
+  }
+  return m_doublePayoffs[pl];
+}
+
+const Array<Rational> &
+GameTableRep::GetPayoffTable(int pl, const Rational &) const
+{
+  if (!m_hasRationalPayoffs) {
+    std::lock_guard<std::mutex> lock(m_payoffsMutex);
+    if (!m_hasRationalPayoffs) {
+      BuildPayoffTable(m_rationalPayoffs);
+      m_hasRationalPayoffs = true;
+    }
+  }
+  return m_rationalPayoffs[pl];
+}
+
 //------------------------------------------------------------------------
 //                   GameTableRep: Writing data files
 //------------------------------------------------------------------------
@@ -341,10 +402,49 @@ MixedStrategyProfile<Rational> GameTableRep::NewMixedStrategyProfile(const Ratio
   return new TableMixedStrategyProfileRep<Rational>(spt);
 }
 
+//------------------------------------------------------------------------
+//              GameTableRep: Managing the representation
+//------------------------------------------------------------------------
+
+void GameTableRep::ClearComputedValues(void) const
+{
+  ClearComputedPayoffs();
+}
+
+void GameTableRep::ClearComputedPayoffs(void) const
+{
+  // Nothing to do while the tables have not been built; this is the
+  // usual case when many payoffs are being set, as when reading a file
+  if (!m_hasDoublePayoffs && !m_hasRationalPayoffs) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_payoffsMutex);
+  m_hasDoublePayoffs = false;
+  m_hasRationalPayoffs = false;
+  m_doublePayoffs = Array<Array<double> >();
+  m_rationalPayoffs = Array<Array<Rational> >();
+}
+
 //------------------------------------------------------------------------
 //              GameTableRep: Private auxiliary functions
 //------------------------------------------------------------------------
 
+template <class T>
+void GameTableRep::BuildPayoffTable(Array<Array<T> > &p_table) const
+{
+  p_table = Array<Array<T> >(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    p_table[pl] = Array<T>(m_results.Length());
+  }
+
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    const GameOutcomeRep *outcome = m_results[cont];
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      p_table[pl][cont] = (outcome) ? outcome->GetPayoff<T>(pl) : (T) 0;
+    }
+  }
+}
+
 /// This rebuilds a new table of outcomes after the game has been
 /// redimensioned (change in the number of strategies).  Strategies
 /// numbered -1 are identified as the new strategies.
@@ -380,6 +480,7 @@ void GameTableRep::RebuildTable(void)
   }
 
   m_results = newResults;
+  ClearComputedPayoffs();
 
   IndexStrategies();
 }
@@ -20,8 +20,12 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <unordered_map>
 
 #include "gambit/gambit.h"
 #include "gambit/gametree.h"
@@ -435,10 +439,7 @@ void GameTreeNodeRep::MoveTree(GameNode p_src)
 
 Game GameTreeNodeRep::CopySubgame(void) const
 {
-  std::ostringstream os;
-  m_efg->WriteEfgFile(os, const_cast<GameTreeNodeRep *>(this));
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  return m_efg->CopySubgame(this);
 }
 
 void GameTreeNodeRep::SetInfoset(GameInfoset p_infoset)
@@ -550,7 +551,12 @@ GameInfoset GameTreeNodeRep::InsertMove(GameInfoset p_infoset)
 //------------------------------------------------------------------------
 
 GameTreeRep::GameTreeRep(void)
-  : m_computedValues(false), m_doCanon(true)
+  : m_computedValues(false), m_doCanon(true), m_hasLayout(false),
+    m_numContingencies(0), m_maxPayoffTable(0),
+    m_hasDoublePayoffs(false), m_hasRationalPayoffs(false),
+    m_hasRecall(false), m_perfectRecall(true),
+    m_recallInfoset1(0), m_recallInfoset2(0),
+    m_transactionDepth(0), m_deferredCanon(false)
 {
   m_chance = new GamePlayerRep(this, 0);
   m_root = new GameTreeNodeRep(this, 0);
@@ -564,10 +570,146 @@ GameTreeRep::~GameTreeRep()
 
 Game GameTreeRep::Copy(void) const
 {
-  std::ostringstream os;
-  WriteEfgFile(os);
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  // The copy is built directly from this game's objects, keeping the
+  // numbering of outcomes, information sets and nodes; payoffs and
+  // chance probabilities are copied as Numbers, without parsing any text.
+  GameTreeRep *efg = new GameTreeRep();
+  Game game = efg;
+  efg->m_title = m_title;
+  efg->m_comment = m_comment;
+  efg->m_maxPayoffTable = m_maxPayoffTable;
+
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = new GamePlayerRep(efg, pl);
+    player->m_label = m_players[pl]->m_label;
+    efg->m_players.Append(player);
+  }
+
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    GameOutcomeRep *outcome = new GameOutcomeRep(efg, outc);
+    outcome->m_label = m_outcomes[outc]->m_label;
+    outcome->m_payoffs = m_outcomes[outc]->m_payoffs;
+    efg->m_outcomes.Append(outcome);
+  }
+
+  std::unordered_map<const GameTreeInfosetRep *, GameTreeInfosetRep *> infosets;
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    GamePlayerRep *copyPlayer = (pl) ? efg->m_players[pl] : efg->m_chance;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      const GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      GameTreeInfosetRep *copy =
+	new GameTreeInfosetRep(efg, infoset->m_number, copyPlayer,
+			       infoset->m_actions.Length());
+      copy->m_label = infoset->m_label;
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	copy->m_actions[act]->m_label = infoset->m_actions[act]->m_label;
+      }
+      copy->m_probs = infoset->m_probs;
+      copy->m_members = Array<GameTreeNodeRep *>(infoset->m_members.Length());
+      infosets[infoset] = copy;
+    }
+  }
+
+  // Copy the nodes, remembering the copy of each decision node so that
+  // the members of each information set can be filled in in their order
+  std::unordered_map<const GameTreeNodeRep *, GameTreeNodeRep *> nodes;
+  std::vector<std::pair<const GameTreeNodeRep *, GameTreeNodeRep *> > stack;
+  stack.push_back(std::make_pair(m_root, efg->m_root));
+  while (!stack.empty()) {
+    const GameTreeNodeRep *node = stack.back().first;
+    GameTreeNodeRep *copy = stack.back().second;
+    stack.pop_back();
+
+    copy->number = node->number;
+    copy->m_label = node->m_label;
+    if (node->outcome) {
+      copy->outcome = efg->m_outcomes[node->outcome->m_number];
+    }
+    if (node->infoset) {
+      copy->infoset = infosets[node->infoset];
+      nodes[node] = copy;
+      for (int i = 1; i <= node->children.Length(); i++) {
+	copy->children.Append(new GameTreeNodeRep(efg, copy));
+	stack.push_back(std::make_pair(node->children[i], copy->children[i]));
+      }
+    }
+  }
+
+  for (auto iter = infosets.begin(); iter != infosets.end(); ++iter) {
+    const Array<GameTreeNodeRep *> &members = iter->first->m_members;
+    for (int i = 1; i <= members.Length(); i++) {
+      iter->second->m_members[i] = nodes[members[i]];
+    }
+  }
+
+  // Games are only left uncanonicalized while they are being built
+  // or edited in a transaction
+  if (!m_doCanon || m_deferredCanon) {
+    efg->Canonicalize();
+  }
+  return game;
+}
+
+Game GameTreeRep::CopySubgame(const GameTreeNodeRep *p_root) const
+{
+  // As when reading the subgame back from a savefile, only the outcomes
+  // and information sets which appear in the subtree are copied, and
+  // they are numbered in the order in which they first appear.
+  GameTreeRep *efg = new GameTreeRep();
+  Game game = efg;
+  efg->m_title = m_title;
+  efg->m_comment = m_comment;
+  efg->m_maxPayoffTable = m_maxPayoffTable;
+  efg->SetCanonicalization(false);
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    efg->NewPlayer()->SetLabel(m_players[pl]->m_label);
+  }
+
+  std::unordered_map<const GameOutcomeRep *, GameOutcomeRep *> outcomes;
+  std::unordered_map<const GameTreeInfosetRep *, GameTreeInfosetRep *> infosets;
+  std::vector<std::pair<const GameTreeNodeRep *, GameTreeNodeRep *> > stack;
+  stack.push_back(std::make_pair(p_root, efg->m_root));
+  while (!stack.empty()) {
+    const GameTreeNodeRep *node = stack.back().first;
+    GameTreeNodeRep *copy = stack.back().second;
+    stack.pop_back();
+
+    copy->m_label = node->m_label;
+    if (node->outcome) {
+      GameOutcomeRep *&outcome = outcomes[node->outcome];
+      if (!outcome) {
+	outcome = new GameOutcomeRep(efg, efg->m_outcomes.Length() + 1);
+	outcome->m_label = node->outcome->m_label;
+	outcome->m_payoffs = node->outcome->m_payoffs;
+	efg->m_outcomes.Append(outcome);
+      }
+      copy->outcome = outcome;
+    }
+    if (node->infoset) {
+      GameTreeInfosetRep *&infoset = infosets[node->infoset];
+      if (!infoset) {
+	int pl = node->infoset->m_player->m_number;
+	GamePlayerRep *player = (pl) ? efg->m_players[pl] : efg->m_chance;
+	infoset = new GameTreeInfosetRep(efg, player->m_infosets.Length() + 1,
+					 player, node->infoset->m_actions.Length());
+	infoset->m_label = node->infoset->m_label;
+	for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	  infoset->m_actions[act]->m_label = node->infoset->m_actions[act]->m_label;
+	}
+	infoset->m_probs = node->infoset->m_probs;
+      }
+      copy->AppendMove(infoset);
+      // Children are visited in order, so that outcomes and information
+      // sets are numbered as they are in the savefile
+      for (int i = node->children.Length(); i >= 1; i--) {
+	stack.push_back(std::make_pair(node->children[i], copy->children[i]));
+      }
+    }
+  }
+
+  efg->SetCanonicalization(true);
+  return game;
 }
 
 Game NewTree(void)  { return new GameTreeRep(); }
@@ -621,53 +763,93 @@ bool GameTreeRep::IsConstSum(void) const
 
 bool GameTreeRep::IsPerfectRecall(GameInfoset &s1, GameInfoset &s2) const
 {
-  for (int pl = 1; pl <= m_players.Length(); pl++)   {
-    GamePlayerRep *player = m_players[pl];
-    
-    for (int i = 1; i <= player->NumInfosets(); i++)  {
-      GameTreeInfosetRep *iset1 = player->m_infosets[i];
-      for (int j = 1; j <= player->NumInfosets(); j++)   {
-	GameTreeInfosetRep *iset2 = player->m_infosets[j];
-
-	bool precedes = false;
-	int action = 0;
-	
-	for (int m = 1; m <= iset2->NumMembers(); m++)  {
-	  int n;
-	  for (n = 1; n <= iset1->NumMembers(); n++)  {
-	    if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)) &&
-	        iset1->GetMember(n) != iset2->GetMember(m))  {
-	      precedes = true;
-	      for (int act = 1; act <= iset1->NumActions(); act++)  {
-		if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)->GetChild(act))) {
-		  if (action != 0 && action != act)  {
-		    s1 = iset1;
-		    s2 = iset2;
-		    return false;
-		  }
-		  action = act;
-		}
-	      }
-	      break;
-	    }
-	  }
-	  
-	  if (i == j && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
+  if (!m_hasRecall) {
+    std::lock_guard<std::mutex> lock(m_computedMutex);
+    if (!m_hasRecall) {
+      BuildPerfectRecall();
+      m_hasRecall = true;
+    }
+  }
+  if (!m_perfectRecall) {
+    s1 = m_recallInfoset1;
+    s2 = m_recallInfoset2;
+  }
+  return m_perfectRecall;
+}
 
-	  if (n > iset1->NumMembers() && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
-	}
+//
+// The game has perfect recall if all members of each information set
+// share the sequence of actions of its player leading to them.  If the
+// sequences agree at each information set reached before, they agree
+// here as soon as their last actions do, so one visit to each node
+// suffices.
+//
+void GameTreeRep::BuildPerfectRecall(void) const
+{
+  Array<GameTreeActionRep *> lastActions(m_players.Length());
+  // The last action of its player before the members of each
+  // information set visited so far
+  Array<Array<GameTreeActionRep *> > infosetActions(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    lastActions[pl] = 0;
+    infosetActions[pl] = Array<GameTreeActionRep *>(m_players[pl]->m_infosets.Length());
+    for (int iset = 1; iset <= infosetActions[pl].Length(); 
+	 infosetActions[pl][iset++] = 0);
+  }
+  Array<Array<bool> > visited(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    visited[pl] = Array<bool>(m_players[pl]->m_infosets.Length());
+    for (int iset = 1; iset <= visited[pl].Length(); visited[pl][iset++] = false);
+  }
+
+  m_recallInfoset1 = m_recallInfoset2 = 0;
+  m_perfectRecall = CheckPerfectRecall(m_root, lastActions, 
+				       infosetActions, visited);
+}
+
+bool 
+GameTreeRep::CheckPerfectRecall(const GameTreeNodeRep *p_node,
+				Array<GameTreeActionRep *> &p_lastActions,
+				Array<Array<GameTreeActionRep *> > &p_infosetActions,
+				Array<Array<bool> > &p_visited) const
+{
+  if (p_node->IsTerminal())  return true;
+
+  GameTreeInfosetRep *infoset = p_node->infoset;
+  int pl = infoset->m_player->m_number;
+  if (pl == 0) {
+    for (int i = 1; i <= p_node->children.Length(); i++) {
+      if (!CheckPerfectRecall(p_node->children[i], p_lastActions,
+			      p_infosetActions, p_visited)) {
+	return false;
       }
     }
+    return true;
+  }
+
+  GameTreeActionRep *lastAction = p_lastActions[pl];
+  int iset = infoset->m_number;
+  if (!p_visited[pl][iset]) {
+    p_visited[pl][iset] = true;
+    p_infosetActions[pl][iset] = lastAction;
+  }
+  else if (p_infosetActions[pl][iset] != lastAction) {
+    // Report the information set at which the sequences diverge, 
+    // which is this one if one member follows another
+    GameTreeActionRep *action = (lastAction) ? lastAction : p_infosetActions[pl][iset];
+    m_recallInfoset1 = action->m_infoset;
+    m_recallInfoset2 = infoset;
+    return false;
   }
 
+  for (int i = 1; i <= p_node->children.Length(); i++) {
+    p_lastActions[pl] = infoset->m_actions[i];
+    if (!CheckPerfectRecall(p_node->children[i], p_lastActions,
+			    p_infosetActions, p_visited)) {
+      return false;
+    }
+  }
+  p_lastActions[pl] = lastAction;
   return true;
 }
 
@@ -683,48 +865,69 @@ void GameTreeRep::NumberNodes(GameTreeNodeRep *n, int &index)
        NumberNodes(n->children[child++], index));
 } 
 
+namespace {
+
+bool PrecedesMember(const GameTreeNodeRep *p_node1, 
+		    const GameTreeNodeRep *p_node2)
+{ return p_node1->GetNumber() < p_node2->GetNumber(); }
+
+/// Information sets are ordered by their first members, those without
+/// members coming last
+bool PrecedesInfoset(const GameTreeInfosetRep *p_infoset1,
+		     const GameTreeInfosetRep *p_infoset2)
+{
+  if (p_infoset2->NumMembers() == 0)  return false;
+  if (p_infoset1->NumMembers() == 0)  return true;
+  return (p_infoset1->GetMember(1)->GetNumber() < 
+	  p_infoset2->GetMember(1)->GetNumber());
+}
+
+/// Sorts the array, if it is not in order already
+template <class T, class Compare>
+void SortArray(Array<T> &p_array, Compare p_precedes)
+{
+  int i = 1;
+  while (i < p_array.Length() && !p_precedes(p_array[i+1], p_array[i])) {
+    i++;
+  }
+  if (i >= p_array.Length())  return;
+
+  std::vector<T> items;
+  items.reserve(p_array.Length());
+  for (i = 1; i <= p_array.Length(); items.push_back(p_array[i++]));
+  std::stable_sort(items.begin(), items.end(), p_precedes);
+  for (i = 1; i <= p_array.Length(); i++) {
+    p_array[i] = items[i-1];
+  }
+}
+
+}  // end anonymous namespace
+
 void GameTreeRep::Canonicalize(void)
 {
   if (!m_doCanon)  return;
+  if (m_transactionDepth > 0) {
+    m_deferredCanon = true;
+    return;
+  }
+  m_deferredCanon = false;
+
   int nodeindex = 1;
   NumberNodes(m_root, nodeindex);
+  m_hasLayout = false;
 
+  // Most edits leave the members, and the information sets, in order;
+  // those which are not are sorted
   for (int pl = 0; pl <= m_players.Length(); pl++) {
     GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
     
-    // Sort nodes within information sets according to ID.
-    // Coded using a bubble sort for simplicity; large games might
-    // find a quicksort worthwhile.
+    // Sort nodes within information sets according to ID
     for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
-      GameTreeInfosetRep *infoset = player->m_infosets[iset];
-      for (int i = 1; i < infoset->m_members.Length(); i++) {
-	for (int j = 1; j < infoset->m_members.Length() - i; j++) {
-	  if (infoset->m_members[j+1]->number < infoset->m_members[j]->number) {
-	    GameTreeNodeRep *tmp = infoset->m_members[j];
-	    infoset->m_members[j] = infoset->m_members[j+1];
-	    infoset->m_members[j+1] = tmp;
-	  }
-	}
-      }
+      SortArray(player->m_infosets[iset]->m_members, PrecedesMember);
     }
 
     // Sort information sets by the smallest ID among their members
-    // Coded using a bubble sort for simplicity; large games might
-    // find a quicksort worthwhile.
-    for (int i = 1; i < player->m_infosets.Length(); i++) {
-      for (int j = 1; j < player->m_infosets.Length() - i; j++) {
-	int a = ((player->m_infosets[j+1]->m_members.Length()) ?
-		 player->m_infosets[j+1]->m_members[1]->number : 0);
-	int b = ((player->m_infosets[j]->m_members.Length()) ?
-		 player->m_infosets[j]->m_members[1]->number : 0);
-
-	if (a < b || b == 0) {
-	  GameTreeInfosetRep *tmp = player->m_infosets[j];
-	  player->m_infosets[j] = player->m_infosets[j+1];
-	  player->m_infosets[j+1] = tmp;
-	}
-      }
-    }
+    SortArray(player->m_infosets, PrecedesInfoset);
 
     // Reassign information set IDs
     for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
@@ -733,6 +936,16 @@ void GameTreeRep::Canonicalize(void)
   }
 }
 
+void GameTreeRep::CommitTransaction(void)
+{
+  if (m_transactionDepth == 0)  throw UndefinedException();
+  if (--m_transactionDepth == 0 && m_deferredCanon) {
+    // Anything computed during the transaction used the old numbering
+    ClearComputedValues();
+    Canonicalize();
+  }
+}
+
 void GameTreeRep::ClearComputedValues(void) const
 {
   for (int pl = 1; pl <= m_players.Length(); pl++) {
@@ -742,11 +955,24 @@ void GameTreeRep::ClearComputedValues(void) const
   }
 
   m_computedValues = false;
+  m_hasRecall = false;
+  ClearComputedPayoffs();
+}
+
+void GameTreeRep::ClearComputedPayoffs(void) const
+{
+  m_hasLayout = false;
+  m_hasDoublePayoffs = false;
+  m_hasRationalPayoffs = false;
+  m_doublePayoffs = Array<Array<double> >();
+  m_rationalPayoffs = Array<Array<Rational> >();
 }
 
 void GameTreeRep::BuildComputedValues(void)
 {
   if (m_computedValues) return;
+  std::lock_guard<std::mutex> lock(m_computedMutex);
+  if (m_computedValues) return;
 
   Canonicalize();
 
@@ -759,9 +985,262 @@ void GameTreeRep::BuildComputedValues(void)
 	 m_players[pl]->m_strategies[st++]->m_id = id++);
   }
 
+  // Index the strategies as those of a table game, for the tables of
+  // the reduced strategic form, as long as the contingencies can be
+  // counted
+  m_numContingencies = 1;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GameStrategyArray &strategies = m_players[pl]->m_strategies;
+    if (m_numContingencies > LONG_MAX / strategies.Length()) {
+      m_numContingencies = 0;
+    }
+    for (int st = 1; st <= strategies.Length(); st++) {
+      strategies[st]->m_offset = (st - 1) * m_numContingencies;
+    }
+    m_numContingencies *= strategies.Length();
+  }
+
+  if (!m_hasLayout) {
+    BuildLayout();
+    m_hasLayout = true;
+  }
+
   m_computedValues = true;
 }
 
+//------------------------------------------------------------------------
+//              GameTreeRep: Tables of the reduced strategic form
+//------------------------------------------------------------------------
+
+const Array<double> &GameTreeRep::GetPayoffTable(int pl, double) const
+{
+  if (!HasPayoffTable())  throw UndefinedException();
+  if (!m_hasDoublePayoffs) {
+    std::lock_guard<std::mutex> lock(m_computedMutex);
+    if (!m_hasDoublePayoffs) {
+      BuildPayoffTable(m_doublePayoffs);
+      m_hasDoublePayoffs = true;
+    }
+  }
+  return m_doublePayoffs[pl];
+}
+
+const Array<Rational> &
+GameTreeRep::GetPayoffTable(int pl, const Rational &) const
+{
+  if (!HasPayoffTable())  throw UndefinedException();
+  if (!m_hasRationalPayoffs) {
+    std::lock_guard<std::mutex> lock(m_computedMutex);
+    if (!m_hasRationalPayoffs) {
+      BuildPayoffTable(m_rationalPayoffs);
+      m_hasRationalPayoffs = true;
+    }
+  }
+  return m_rationalPayoffs[pl];
+}
+
+template <class T>
+void GameTreeRep::BuildPayoffTable(Array<Array<T> > &p_table) const
+{
+  p_table = Array<Array<T> >(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    p_table[pl] = Array<T>(m_numContingencies);
+  }
+
+  // Visit the contingencies in the order of their indices, with the
+  // first player's strategy varying fastest
+  Array<int> current(m_players.Length());
+  Array<GameStrategyRep *> profile(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    current[pl] = 1;
+    profile[pl] = m_players[pl]->m_strategies[1];
+  }
+  Array<T> payoffs(m_players.Length());
+  for (long index = 1; index <= m_numContingencies; index++) {
+    GetPayoffs(m_root, profile, payoffs);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      p_table[pl][index] = payoffs[pl];
+    }
+
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      const GameStrategyArray &strategies = m_players[pl]->m_strategies;
+      if (current[pl] < strategies.Length()) {
+	profile[pl] = strategies[++current[pl]];
+	break;
+      }
+      profile[pl] = strategies[current[pl] = 1];
+    }
+  }
+}
+
+template <class T>
+void GameTreeRep::GetPayoffs(const GameTreeNodeRep *p_node,
+			     const Array<GameStrategyRep *> &p_profile,
+			     Array<T> &p_payoffs) const
+{
+  // The payoffs are accumulated in the same order as by
+  // PureBehaviorProfile::GetPayoff()
+  for (int pl = 1; pl <= p_payoffs.Length(); pl++) {
+    p_payoffs[pl] = (p_node->outcome) ? 
+      (T(0) + p_node->outcome->GetPayoff<T>(pl)) : T(0);
+  }
+  if (p_node->IsTerminal())  return;
+
+  Array<T> payoffs(p_payoffs.Length());
+  if (p_node->infoset->IsChanceInfoset()) {
+    for (int i = 1; i <= p_node->children.Length(); i++) {
+      GetPayoffs(p_node->children[i], p_profile, payoffs);
+      T prob = p_node->infoset->GetActionProb(i, T(0));
+      for (int pl = 1; pl <= p_payoffs.Length(); pl++) {
+	p_payoffs[pl] += prob * payoffs[pl];
+      }
+    }
+  }
+  else {
+    int pl = p_node->infoset->m_player->m_number;
+    int act = p_profile[pl]->m_behav[p_node->infoset->m_number];
+    GetPayoffs(p_node->children[act], p_profile, payoffs);
+    for (int pl = 1; pl <= p_payoffs.Length(); pl++) {
+      p_payoffs[pl] += payoffs[pl];
+    }
+  }
+}
+
+const GameTreeLayout &GameTreeRep::GetLayout(void) const
+{
+  if (!m_hasLayout) {
+    std::lock_guard<std::mutex> lock(m_computedMutex);
+    if (!m_hasLayout) {
+      BuildLayout();
+      m_hasLayout = true;
+    }
+  }
+  return m_layout;
+}
+
+void GameTreeRep::BuildLayout(void) const
+{
+  GameTreeLayout &layout = m_layout;
+  int numNodes = NumNodes();
+
+  // Number the information sets across all players, chance first,
+  // and the actions of the personal players in order
+  Array<int> firstInfoset(0, m_players.Length());
+  int numInfosets = 0, numMembers = 0;
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    firstInfoset[pl] = numInfosets;
+    numInfosets += player->m_infosets.Length();
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      numMembers += player->m_infosets[iset]->m_members.Length();
+    }
+  }
+  Array<int> firstAction(numInfosets);
+  int numActions = 0;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      firstAction[firstInfoset[pl] + iset] = numActions;
+      numActions += player->m_infosets[iset]->m_actions.Length();
+    }
+  }
+  layout.m_numActions = numActions;
+  layout.m_firstInfoset = firstInfoset;
+
+  layout.m_firstMember = Array<int>(numInfosets);
+  layout.m_numMembers = Array<int>(numInfosets);
+  layout.m_members = Array<int>(numMembers);
+  for (int pl = 0, index = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      layout.m_firstMember[firstInfoset[pl] + iset] = index;
+      layout.m_numMembers[firstInfoset[pl] + iset] = infoset->m_members.Length();
+      for (int i = 1; i <= infoset->m_members.Length(); i++) {
+	layout.m_members[index++] = infoset->m_members[i]->number;
+      }
+    }
+  }
+
+  layout.m_doublePayoffs = Matrix<double>(m_outcomes.Length(), m_players.Length());
+  layout.m_rationalPayoffs = Matrix<Rational>(m_outcomes.Length(), m_players.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      layout.m_doublePayoffs(outc, pl) = m_outcomes[outc]->GetPayoff<double>(pl);
+      layout.m_rationalPayoffs(outc, pl) = m_outcomes[outc]->GetPayoff<Rational>(pl);
+    }
+  }
+
+  layout.m_preorder = Array<int>(numNodes);
+  layout.m_postorder = Array<int>(numNodes);
+  layout.m_parent = Array<int>(numNodes);
+  layout.m_action = Array<int>(numNodes);
+  layout.m_actionIndex = Array<int>(numNodes);
+  layout.m_infoset = Array<int>(numNodes);
+  layout.m_player = Array<int>(numNodes);
+  layout.m_outcome = Array<int>(numNodes);
+  layout.m_firstChild = Array<int>(numNodes);
+  layout.m_numChildren = Array<int>(numNodes);
+  layout.m_children = Array<int>(numNodes - 1);
+  layout.m_doubleProbs = Array<double>(numNodes);
+  layout.m_rationalProbs = Array<Rational>(numNodes);
+
+  int preorder = 0, postorder = 0, children = 0;
+  auto visit = [&](GameTreeNodeRep *p_node, GameTreeNodeRep *p_parent, int p_action) {
+    int node = p_node->number;
+    layout.m_preorder[++preorder] = node;
+    layout.m_parent[node] = (p_parent) ? p_parent->number : 0;
+    layout.m_action[node] = p_action;
+    layout.m_actionIndex[node] = 0;
+    layout.m_doubleProbs[node] = 0.0;
+    layout.m_rationalProbs[node] = Rational(0);
+    if (p_parent) {
+      GameTreeInfosetRep *infoset = p_parent->infoset;
+      int pl = infoset->m_player->m_number;
+      if (pl) {
+	layout.m_actionIndex[node] = 
+	  firstAction[firstInfoset[pl] + infoset->m_number] + p_action;
+      }
+      else {
+	layout.m_doubleProbs[node] = infoset->GetActionProb(p_action, 0.0);
+	layout.m_rationalProbs[node] = infoset->GetActionProb(p_action, Rational(0));
+      }
+    }
+    if (p_node->infoset) {
+      int pl = p_node->infoset->m_player->m_number;
+      layout.m_infoset[node] = firstInfoset[pl] + p_node->infoset->m_number;
+      layout.m_player[node] = pl;
+    }
+    else {
+      layout.m_infoset[node] = 0;
+      layout.m_player[node] = 0;
+    }
+    layout.m_outcome[node] = (p_node->outcome) ? p_node->outcome->m_number : 0;
+    layout.m_firstChild[node] = children + 1;
+    layout.m_numChildren[node] = p_node->children.Length();
+    for (int i = 1; i <= p_node->children.Length(); i++) {
+      layout.m_children[++children] = p_node->children[i]->number;
+    }
+  };
+
+  // Walk the tree without recursion, since trees may be deep
+  std::vector<std::pair<GameTreeNodeRep *, int> > stack;
+  visit(m_root, 0, 0);
+  stack.push_back(std::make_pair(m_root, 0));
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back().first;
+    int act = ++stack.back().second;
+    if (act <= node->children.Length()) {
+      visit(node->children[act], node, act);
+      stack.push_back(std::make_pair(node->children[act], 0));
+    }
+    else {
+      layout.m_postorder[++postorder] = node->number;
+      stack.pop_back();
+    }
+  }
+}
+
 //------------------------------------------------------------------------
 //                  GameTreeRep: Writing data files
 //------------------------------------------------------------------------
@@ -1111,6 +1590,15 @@ void TreePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 
 Rational TreePureStrategyProfileRep::GetPayoff(int pl) const
 {
+  const GameTreeRep &efg = dynamic_cast<const GameTreeRep &>(*m_nfg);
+  if (efg.HasPayoffTable()) {
+    long index = 1L;
+    for (int i = 1; i <= m_profile.Length(); i++) {
+      index += m_profile[i]->m_offset;
+    }
+    return efg.GetPayoffTable(pl, Rational(0))[index];
+  }
+
   PureBehaviorProfile behav(m_nfg);
   for (int i = 1; i <= m_nfg->NumPlayers(); i++) {
     GamePlayer player = m_nfg->GetPlayer(i);
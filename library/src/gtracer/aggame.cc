@@ -26,29 +26,37 @@
 namespace Gambit {
 namespace gametracer {
 
-void aggame::computePartialP_PureNode(int player1,int act1, std::vector<int>& tasks){
+void aggame::computePartialP_PureNode(int player1,int act1, std::vector<int>& tasks,
+                                      agg::AGG::Workspace &w, bool useNodeP){
     int i,j,Node = aggPtr->actionSets[player1][act1];
     int numNei = aggPtr->neighbors[Node].size();
 
     //assert(aggPtr->isPure[Node]||tasks.size()==0);
     std::vector<agg::AggNumber> strat (numNei);
     agg::AGG::config    a(numNei,0);
-    //compute the full distrib
-    aggPtr->computeP (player1,act1);
-
-    //store the full distrib in Pr[player1]
-    aggPtr->Pr[player1].swap(aggPtr->Pr[numPlayers-1]);
+    //compute the full distrib, and store it in Pr[player1]
+    if (useNodeP) {
+      //apply player1's action to the distribution induced by the others
+      agg::aggdistrib own;
+      own.insert(std::make_pair(aggPtr->projection[Node][player1][act1],1.0));
+      w.Pr[player1].multiply(w.nodeP[player1],own,numNei,aggPtr->projFunctions[Node]);
+    }
+    else {
+      aggPtr->computeP (player1,act1,w);
+      w.Pr[player1].swap(w.Pr[numPlayers-1]);
+    }
+    std::vector<agg::aggdistrib> &projectedStrat = w.getProjectedStrat(Node);
     for(i=0;i<(int)tasks.size();i++){
       //assert(tasks[i]!=player1);
-      agg::aggdistrib& P = aggPtr->Pr[tasks[i]];
+      agg::aggdistrib& P = w.Pr[tasks[i]];
       //P.clear();  // to get ready for division, we need clear()
-      P=aggPtr->Pr[player1];
+      P=w.Pr[player1];
 
       bool NullOnly =true;
       for(j=0;j<numNei;++j){
 	a[j]++;
-	agg::aggdistrib::iterator pp = aggPtr->projectedStrat[Node][tasks[i]].find(a);
-	if (pp== aggPtr->projectedStrat[Node][tasks[i]].end()) {
+	agg::aggdistrib::iterator pp = projectedStrat[tasks[i]].find(a);
+	if (pp== projectedStrat[tasks[i]].end()) {
 	    strat[j]=0;
 	}
 	else {
@@ -83,16 +91,18 @@ void aggame::computePartialP(int player1, int act1, std::vector<int>& tasks,std:
 
 void aggame::computePartialP_bisect(int player1,int act1,
     std::vector<int>::iterator start,std::vector<int>::iterator endp,
-    agg::aggdistrib& temp){
+    agg::aggdistrib& temp, agg::AGG::Workspace &w){
   //assert (endp-start>0);
 #ifdef AGGDEBUG
   cout<<"calling computePartialP_bisect with player1="<<player1
     <<", act1="<<act1<<" *start="<<*start<<" *(endp-1)="<<*(endp-1)
     <<", (endp-start)="<< endp-start <<endl;
 #endif
-  if(endp-start==1){aggPtr->Pr[*start].reset();return;}
+  if(endp-start==1){w.Pr[*start].reset();return;}
   int Node = aggPtr->actionSets[player1][act1];
   int numNei=aggPtr->neighbors[Node].size();
+  std::vector<agg::aggdistrib> &Pr = w.Pr;
+  std::vector<agg::aggdistrib> &projectedStrat = w.getProjectedStrat(Node);
 
   int player2;
   std::vector<int>::iterator ptr, mid = start + (endp-start)/2;
@@ -100,32 +110,32 @@ void aggame::computePartialP_bisect(int player1,int act1,
   cout<< "*mid="<<*mid<<" mid-start="<<mid-start<<" endp-mid="
     <<endp-mid <<endl;
 #endif
-  computePartialP_bisect(player1,act1,start,mid,temp);
-  computePartialP_bisect(player1,act1,mid,endp,temp);
+  computePartialP_bisect(player1,act1,start,mid,temp,w);
+  computePartialP_bisect(player1,act1,mid,endp,temp,w);
 
 
   temp.reset();
-  temp = aggPtr->projectedStrat[Node][*start];
-  if (mid-start>1) temp.multiply(aggPtr->Pr[*start],numNei,aggPtr->projFunctions[Node]);
+  temp = projectedStrat[*start];
+  if (mid-start>1) temp.multiply(Pr[*start],numNei,aggPtr->projFunctions[Node]);
 
   if (mid-start==1) {
-    //assert(aggPtr->Pr[*start].empty());
-    aggPtr->Pr[*start]= aggPtr->projectedStrat[Node][*mid];
-    if(endp-mid>1) aggPtr->Pr[*start].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    //assert(Pr[*start].empty());
+    Pr[*start]= projectedStrat[*mid];
+    if(endp-mid>1) Pr[*start].multiply(Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
   else for (ptr=start; ptr!=mid; ++ptr){
     player2= *ptr;
-    aggPtr->Pr[player2].multiply(aggPtr->projectedStrat[Node][*mid],numNei,aggPtr->projFunctions[Node] );
-    if(endp-mid>1) aggPtr->Pr[player2].multiply(aggPtr->Pr[*mid],numNei,aggPtr->projFunctions[Node]);
+    Pr[player2].multiply(projectedStrat[*mid],numNei,aggPtr->projFunctions[Node] );
+    if(endp-mid>1) Pr[player2].multiply(Pr[*mid],numNei,aggPtr->projFunctions[Node]);
   }
 
   if(endp-mid==1){
-    //assert(aggPtr->Pr[*mid].empty());
-    aggPtr->Pr[*mid]=temp;
+    //assert(Pr[*mid].empty());
+    Pr[*mid]=temp;
   }
   else for (ptr=mid;ptr!=endp;++ptr){
     player2=*ptr;
-    aggPtr->Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
+    Pr[player2].multiply(temp,numNei, aggPtr->projFunctions[Node]);
 
   }
 
@@ -144,16 +154,19 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 #endif
   agg::AggNumber fuzzcount;
   int rown, coln, rowi, coli,act1,act2,currNode,numNei;
-  static std::vector<int>::iterator p;
-  static std::vector<int> tasks,spares,nontasks;
+  std::vector<int>::iterator p;
+  std::vector<int> tasks,spares,nontasks;
   tasks.reserve(aggPtr->numPlayers);
   spares.reserve(aggPtr->numPlayers);
   nontasks.reserve(aggPtr->numPlayers);
-  aggPtr->cache.reset();
+  //cache of jacobian entries.
+  agg::trie_map<agg::AggNumber> cache(aggPtr->numPlayers+1);
+  agg::AGG::Workspace w(*aggPtr);
+  std::vector<agg::aggdistrib> &Pr = w.Pr;
 
   //do projection
   for(int Node=0; Node< aggPtr->numActionNodes; Node++)
-	aggPtr->doProjection(Node,s.values());
+	aggPtr->doProjection(Node,s.values(),w);
 
   //deal with the diagonal
   for (rown=0; rown<aggPtr->numPlayers; ++rown){
@@ -165,15 +178,25 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	    }
 	  }
   }
-  for(rown=0;rown<aggPtr->numPlayers; ++rown){   //rown: the row player
-	for(act1=0;act1<aggPtr->actions[rown];act1++){  //act1: player rown's action
+  //go through the rows action node by action node, so the rows for
+  //the same node can share the distributions from computeNodeP()
+  std::vector<std::vector<std::pair<int,int> > > rows(aggPtr->numActionNodes);
+  for(rown=0;rown<aggPtr->numPlayers; ++rown){
+    for(act1=0;act1<aggPtr->actions[rown];act1++){
+      rows[aggPtr->actionSets[rown][act1]].push_back(std::make_pair(rown,act1));
+    }
+  }
+  for(currNode=0;currNode<aggPtr->numActionNodes;++currNode){
+        bool hasNodeP=false;
+	for(size_t row=0;row<rows[currNode].size();row++){
+	    rown=rows[currNode][row].first;    //rown: the row player
+	    act1=rows[currNode][row].second;   //act1: player rown's action
 
-	    currNode =aggPtr->actionSets[rown][act1];
 	    numNei= aggPtr->neighbors[currNode].size();
 #ifdef AGGDEBUG
             cout<<"for player "<<rown<<", action "<<act1
                 <<", action node "<<currNode<<endl;
-	    cout<< "cache is: "<<endl<<aggPtr->cache<<endl;
+	    cout<< "cache is: "<<endl<<cache<<endl;
 #endif
 	    tasks.clear();  //for these col players, we need to compute the distribution induced by their complements. input of the bisection alg
 	    spares.clear(); //these col players have only one projected action
@@ -197,8 +220,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
                 copy(key.begin(),key.end(),ostream_iterator<int>(cout," ") );
                 cout<<"]\n";
 #endif
-	        agg::aggdistrib::iterator r= aggPtr->cache.findExact(key);
-	        if (r!=aggPtr->cache.end()){
+	        agg::aggdistrib::iterator r= cache.findExact(key);
+	        if (r!=cache.end()){
 	          dest[act1+firstAction(rown)][act2+firstAction(coln)]=r->second;
 	        }
 	        else{
@@ -230,35 +253,40 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	    if (tasks.size()==0 && spares.size()==0) continue; //nothing to be done for this row
 
 	    if(aggPtr->isPure[currNode]||tasks.size()==0){
-	      computePartialP_PureNode(rown, act1,tasks);
+	      bool useNodeP=(rows[currNode].size()>1);
+	      if(useNodeP && !hasNodeP){
+	        aggPtr->computeNodeP(currNode,w);
+	        hasNodeP=true;
+	      }
+	      computePartialP_PureNode(rown, act1,tasks,w,useNodeP);
 	    }else{//do bisection
-	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),aggPtr->Pr[rown]);
+	      computePartialP_bisect(rown,act1,tasks.begin(),tasks.end(),Pr[rown],w);
 #ifdef AGGDEBUG
               cout<<"after calling computePartialP_bisect:"<<endl;
               for (int tt=0;tt<tasks.size();tt++){
                 cout<<"for player "<<tasks[tt]<<endl;
-                cout<<aggPtr->Pr[tasks[tt]]<<endl;
+                cout<<Pr[tasks[tt]]<<endl;
               }
 #endif
 	      //now apply rown's action (act1), and the strategies of
 	      //players in nontasks
-          aggPtr->Pr[rown].reset();
-          aggPtr->Pr[rown].insert(
+          Pr[rown].reset();
+          Pr[rown].insert(
 		    make_pair(aggPtr->projection[currNode][rown][act1],1.0));
 	      for(p=nontasks.begin();p!=nontasks.end();++p)
-	    	  aggPtr->Pr[rown].multiply(aggPtr->projectedStrat[currNode][*p],numNei, aggPtr->projFunctions[currNode]);
+	    	  Pr[rown].multiply(w.getProjectedStrat(currNode)[*p],numNei, aggPtr->projFunctions[currNode]);
 #ifdef AGGDEBUG
               cout<<"the polynomial product of strats of player "
                   <<rown<< " and players in the vector nontasks is:"
                   <<endl;
-              cout<<aggPtr->Pr[rown]<<endl;
+              cout<<Pr[rown]<<endl;
 #endif
 	      if (tasks.size()==1){
-	    	  aggPtr->Pr[tasks[0]]=aggPtr->Pr[rown];
+	    	  Pr[tasks[0]]=Pr[rown];
 	      }
 	      else {
                 for(p=tasks.begin();p!=tasks.end();++p){
-		  if(aggPtr->Pr[*p].size()==0){
+		  if(Pr[*p].size()==0){
 		    std::cerr<<"AGG::payoffMatrix() ERROR for rown="
 		        <<rown<<" act1="<<act1<<" *p=" <<*p
 			     <<": the distribution should not be empty!"<<std::endl;
@@ -267,8 +295,8 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 #endif
 
 		  }
-		  aggPtr->Pr[*p].multiply(
-				  aggPtr->Pr[rown],numNei,aggPtr->projFunctions[currNode]);
+		  Pr[*p].multiply(
+				  Pr[rown],numNei,aggPtr->projFunctions[currNode]);
 	        }//end for(p=tasks.begin...
 	      }
 
@@ -277,10 +305,10 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	      //we store this distrib in Pr[rown][act1][rown]
 	      if (spares.size()>0){
 		//assert(tasks.size()>0);
-	    	  aggPtr->Pr[rown].reset();
-	    	  aggPtr->Pr[rown].multiply(
-	    			  aggPtr->Pr[tasks[0]],
-	    			  aggPtr->projectedStrat[currNode][tasks[0]],numNei,aggPtr->projFunctions[currNode]);
+	    	  Pr[rown].reset();
+	    	  Pr[rown].multiply(
+	    			  Pr[tasks[0]],
+	    			  w.getProjectedStrat(currNode)[tasks[0]],numNei,aggPtr->projFunctions[currNode]);
 	      }
 	    } //end else
 #ifdef AGGDEBUG
@@ -288,7 +316,7 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
                 <<endl;
             for (int tt = 0;tt<numPlayers;tt++){
               cout<<"for player "<<tt<<endl;
-              cout<<aggPtr->Pr[tt];
+              cout<<Pr[tt];
               cout<<endl;
             }
 #endif
@@ -297,40 +325,41 @@ void aggame::payoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 	    bool hasUndisturbed=false;
 
 	    if(spares.size()>0){//for players in spares, we compute one undisturbed payoff
-	      computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1, rown);
+	      computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1, rown,w);
 	      for(p=spares.begin();p!=spares.end();++p)
 		for(act2=0;act2<aggPtr->actions[*p];act2++)
-		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,aggPtr->cache);
+		  savePayoff(dest,rown,act1,*p,act2, undisturbedPayoff,cache);
 
 	    }
 	    for(p=tasks.begin();p!=tasks.end();++p){
 	      for(act2=0;act2<aggPtr->actions[*p];act2++){//act2: col action
 
-		if (aggPtr->projectedStrat[currNode][*p].size()==1  &&
-				aggPtr->projectedStrat[currNode][*p].begin()->first==aggPtr->projection[currNode][*p][act2])
+		if (w.getProjectedStrat(currNode)[*p].size()==1  &&
+				w.getProjectedStrat(currNode)[*p].begin()->first==aggPtr->projection[currNode][*p][act2])
 		{
-		  computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1,*p);
-		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,aggPtr->cache);
+		  computeUndisturbedPayoff(undisturbedPayoff,hasUndisturbed,rown,act1,*p,w);
+		  savePayoff(dest,rown,act1,*p,act2,undisturbedPayoff,cache);
 		}
-		computePayoff(dest,rown,act1,*p,act2,aggPtr->cache);
+		computePayoff(dest,rown,act1,*p,act2,cache,w);
 	      }//end for(act2
 	    }//end for(p
-	}//end for(act1
-  }//end for(rown
+	}//end for(row
+  }//end for(currNode
 }
 
 
-void aggame::computeUndisturbedPayoff(agg::AggNumber& undisturbedPayoff,bool& has,int player1,int act1,int player2)
+void aggame::computeUndisturbedPayoff(agg::AggNumber& undisturbedPayoff,bool& has,int player1,int act1,int player2,
+                                      agg::AGG::Workspace &w)
 {
   if (has) return;
   int    Node =aggPtr->actionSets[player1][act1];
   int    numNei= aggPtr->neighbors[Node].size();
   if (player2==player1){
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(aggPtr->payoffs[Node]);
+    undisturbedPayoff=w.Pr[player2].inner_prod(aggPtr->payoffs[Node]);
   }else{
-    //assert(aggPtr->projectedStrat[Node][player2].size()==1);
-    undisturbedPayoff=aggPtr->Pr[player2].inner_prod(
-    		aggPtr->projectedStrat[Node][player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
+    //assert(w.getProjectedStrat(Node)[player2].size()==1);
+    undisturbedPayoff=w.Pr[player2].inner_prod(
+    		w.getProjectedStrat(Node)[player2].begin()->first,numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
   }
   has=true;
 }
@@ -362,7 +391,8 @@ void aggame::savePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,
   dest[act1+firstAction(player1)][act2+firstAction(player2)]=result;
 
 }
-void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,agg::trie_map<agg::AggNumber>& cache){
+void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int act2,agg::trie_map<agg::AggNumber>& cache,
+                           agg::AGG::Workspace &w){
   int    Node =aggPtr->actionSets[player1][act1];
   int    numNei= aggPtr->neighbors[Node].size();
 
@@ -375,7 +405,7 @@ void aggame::computePayoff(cmatrix& dest,int player1,int act1,int player2,int ac
   if (! r.second) {
     dest[act1+firstAction(player1)][act2+firstAction(player2)]=r.first->second;
   }else{
-    r.first->second=aggPtr->Pr[player2].inner_prod(
+    r.first->second=w.Pr[player2].inner_prod(
     		aggPtr->projection[Node][player2][act2],numNei,aggPtr->projFunctions[Node],aggPtr->payoffs[Node]);
     savePayoff(dest,player1,act1,player2,act2,r.first->second,cache,r.second);
   }
@@ -390,7 +420,9 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
   }
   //assert(getNumPlayers()>1);
 
-  aggPtr->cache.clear();
+  //cache of jacobian entries.
+  agg::trie_map<agg::AggNumber> cache(aggPtr->numPlayers+1);
+  agg::AGG::Workspace w(*aggPtr);
 
   agg::AggNumber fuzzcount;
 
@@ -400,10 +432,10 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
     numNei= aggPtr->neighbors[currNode].size();
     //std::vector<int> key (numNei+1);
     //key[numNei]=currNode;
-    aggPtr->doProjection(currNode,0,&(s[firstAction(0)]));
-    agg::aggdistrib &Pdest = aggPtr->Pr[numPlayers-1];
-    aggPtr->projectedStrat[currNode][0].power(numPlayers-2, Pdest, aggPtr->Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
-    agg::aggdistrib &temp=aggPtr->Pr[numPlayers-2];
+    aggPtr->doProjection(currNode,0,&(s[firstAction(0)]),w);
+    agg::aggdistrib &Pdest = w.Pr[numPlayers-1];
+    w.getProjectedStrat(currNode)[0].power(numPlayers-2, Pdest, w.Pr[numPlayers-2],numNei,aggPtr->projFunctions[currNode]);
+    agg::aggdistrib &temp=w.Pr[numPlayers-2];
     temp.reset();
     temp.insert(make_pair(aggPtr->projection[currNode][0][rowa],1));
     Pdest.multiply(temp,numNei,aggPtr->projFunctions[currNode]);
@@ -412,7 +444,7 @@ void aggame::SymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 
       //insPair.first.reserve(numNei+3);
       insPair.first.push_back(currNode);
-      std::pair<agg::trie_map<agg::AggNumber>::iterator,bool> r =aggPtr->cache.insert(insPair);
+      std::pair<agg::trie_map<agg::AggNumber>::iterator,bool> r =cache.insert(insPair);
 
       if (! r.second) {
           dest[rowa][cola]=r.first->second;
@@ -440,6 +472,7 @@ void aggame::KSymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
   //exit(1);
 
   std::vector<double> sp (s.values(), s.values()+s.getm());
+  agg::AGG::Workspace w(*aggPtr);
   //simple implementation using expected payoffs:
   for(int rowcls=0;rowcls<getNumPlayerClasses();++rowcls){
     for(int rowa = 0; rowa<getNumKSymActions(rowcls);++rowa){
@@ -450,7 +483,7 @@ void aggame::KSymPayoffMatrix(cmatrix &dest, cvector &s, agg::AggNumber fuzz){
 
           dest[rowa+firstKSymAction(rowcls)][cola+firstKSymAction(colcls)]=
               (agg::AggNumber)multiplier *
-              aggPtr->getKSymMixedPayoff(sp,rowcls,rowa,colcls,cola);
+              aggPtr->getKSymMixedPayoff(sp,rowcls,rowa,colcls,cola,w);
         }
       }
     }
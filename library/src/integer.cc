@@ -122,6 +122,43 @@ inline static unsigned long up(unsigned long x)
   return x << I_SHIFT;
 }
 
+// Presents the value of an Integer as an IntegerRep, for passing
+// to the arbitrary-precision routines.  A value held in a long is
+// written out into a buffer in this object, which is marked as static
+// (sz == 0) so that the routines never resize or free it.
+
+class IntegerRepOf {
+private:
+  union {
+    IntegerRep rep;
+    unsigned short words[sizeof(IntegerRep) / sizeof(short) + SHORT_PER_LONG];
+  } m_buffer;
+  const IntegerRep *m_rep;
+
+public:
+  explicit IntegerRepOf(const Integer &x)
+  {
+    if (x.rep) {
+      m_rep = x.rep;
+      return;
+    }
+    IntegerRep *rep = &m_buffer.rep;
+    unsigned long u = (x.val >= 0) ? (unsigned long) x.val : -(unsigned long) x.val;
+    rep->len = 0;
+    rep->sz = 0;
+    rep->sgn = (x.val >= 0) ? I_POSITIVE : I_NEGATIVE;
+    while (u != 0)
+    {
+      rep->s[rep->len++] = extract(u);
+      u >>= I_SHIFT;
+    }
+    m_rep = rep;
+  }
+
+  operator const IntegerRep *(void) const { return m_rep; }
+  const IntegerRep *operator->(void) const { return m_rep; }
+};
+
 // compare two equal-length reps
 
 static int docmp(const unsigned short* x, const unsigned short* y, int l)
@@ -309,7 +346,7 @@ IntegerRep* Icopy(IntegerRep* old, const IntegerRep* src)
 IntegerRep* Icopy_long(IntegerRep* old, long x)
 {
   int newsgn = (x >= 0);
-  IntegerRep* rep = Icopy_ulong(old, newsgn ? x : -x);
+  IntegerRep* rep = Icopy_ulong(old, newsgn ? (unsigned long) x : -(unsigned long) x);
   rep->sgn = newsgn;
   return rep;
 }
@@ -322,7 +359,7 @@ IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
   while (x != 0)
   {
     src[srclen++] = extract(x);
-    x = down(x);
+    x >>= I_SHIFT;
   }
 
   IntegerRep* rep;
@@ -494,6 +531,7 @@ double ratio(const Integer& num, const Integer& den)
   Integer q, r;
   divide(num, den, q, r);
   double d1 = q.as_double();
+  IntegerRepOf denrep(den), rrep(r);
  
   if (d1 >= DBL_MAX || d1 <= -DBL_MAX || sign(r) == 0)
     return d1;
@@ -502,7 +540,7 @@ double ratio(const Integer& num, const Integer& den)
     double  d2 = 0.0;
     double  d3 = 0.0; 
     int cont = 1;
-    for (int i = den.rep->len - 1; i >= 0 && cont; --i)
+    for (int i = denrep->len - 1; i >= 0 && cont; --i)
     {
 		unsigned short a = (unsigned short) (I_RADIX >> 1);
       while (a != 0)
@@ -514,13 +552,13 @@ double ratio(const Integer& num, const Integer& den)
         }
 
         d2 *= 2.0;
-        if (den.rep->s[i] & a)
+        if (denrep->s[i] & a)
           d2 += 1.0;
 
-        if (i < r.rep->len)
+        if (i < rrep->len)
         {
           d3 *= 2.0;
-          if (r.rep->s[i] & a)
+          if (rrep->s[i] & a)
             d3 += 1.0;
         }
 
@@ -591,7 +629,7 @@ int compare(const IntegerRep* x, long  y)
         while (uy != 0)
         {
           tmp[yl++] = extract(uy);
-          uy = down(uy);
+          uy >>= I_SHIFT;
         }
         diff = xl - yl;
         if (diff == 0)
@@ -620,7 +658,7 @@ int ucompare(const IntegerRep* x, long  y)
       while (uy != 0)
       {
         tmp[yl++] = extract(uy);
-        uy = down(uy);
+        uy >>= I_SHIFT;
       }
       diff = xl - yl;
       if (diff == 0)
@@ -781,7 +819,7 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
     while (as < topa && uy != 0)
     {
       unsigned long u = extract(uy);
-      uy = down(uy);
+      uy >>= I_SHIFT;
       sum += (unsigned long)(*as++) + u;
       *rs++ = extract(sum);
       sum = down(sum);
@@ -805,7 +843,7 @@ IntegerRep* add(const IntegerRep* x, int negatex, long y, IntegerRep* r)
     while (uy != 0)
     {
       tmp[yl++] = extract(uy);
-      uy = down(uy);
+      uy >>= I_SHIFT;
     }
     int comp = xl - yl;
     if (comp == 0)
@@ -1033,7 +1071,7 @@ IntegerRep* multiply(const IntegerRep* x, long y, IntegerRep* r)
     while (uy != 0)
     {
       tmp[yl++] = extract(uy);
-      uy = down(uy);
+      uy >>= I_SHIFT;
     }
 
     int rl = xl + yl;
@@ -1296,7 +1334,7 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
   while (u != 0)
   {
     ys[yl++] = extract(u);
-    u = down(u);
+    u >>= I_SHIFT;
   }
 
   int comp = xl - yl;
@@ -1349,7 +1387,13 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
 
 void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
 {
-  const IntegerRep* x = Ix.rep;
+  if (!Ix.rep && y != 0 && (y != -1 || Ix.val != LONG_MIN)) {
+    rem = Ix.val % y;
+    Iq.Assign(Ix.val / y);
+    return;
+  }
+  IntegerRepOf xrep(Ix);
+  const IntegerRep* x = xrep;
   nonnil(x);
   IntegerRep* q = Iq.rep;
   int xl = x->len;
@@ -1367,7 +1411,7 @@ void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
   while (u != 0)
   {
     ys[yl++] = extract(u);
-    u = down(u);
+    u >>= I_SHIFT;
   }
 
   int comp = xl - yl;
@@ -1428,15 +1472,22 @@ void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
   if (xsgn == I_NEGATIVE) rem = -rem;
   q->sgn = samesign;
   Icheck(q);
-  Iq.rep = q;
+  Iq.Assign(q);
 }
 
 
 void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
 {
-  const IntegerRep* x = Ix.rep;
+  if (!Ix.rep && !Iy.rep && Iy.val != 0 && (Iy.val != -1 || Ix.val != LONG_MIN)) {
+    long x = Ix.val, y = Iy.val;
+    Iq.Assign(x / y);
+    Ir.Assign(x % y);
+    return;
+  }
+  IntegerRepOf xrep(Ix), yrep(Iy);
+  const IntegerRep* x = xrep;
   nonnil(x);
-  const IntegerRep* y = Iy.rep;
+  const IntegerRep* y = yrep;
   nonnil(y);
   IntegerRep* q = Iq.rep;
   IntegerRep* r = Ir.rep;
@@ -1497,12 +1548,13 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
       Icheck(r);
       unscale(r->s, r->len, prescale, r->s);
     }
+    r->sgn = xsgn;
   }
   q->sgn = samesign;
   Icheck(q);
-  Iq.rep = q;
+  Iq.Assign(q);
   Icheck(r);
-  Ir.rep = r;
+  Ir.Assign(r);
 }
 
 IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
@@ -1555,6 +1607,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
       Icheck(r);
       unscale(r->s, r->len, prescale, r->s);
     }
+    r->sgn = xsgn;
   }
   Icheck(r);
   return r;
@@ -1578,7 +1631,7 @@ IntegerRep* mod(const IntegerRep* x, long y, IntegerRep* r)
   while (u != 0)
   {
     ys[yl++] = extract(u);
-    u = down(u);
+    u >>= I_SHIFT;
   }
 
   int comp = xl - yl;
@@ -1621,6 +1674,7 @@ IntegerRep* mod(const IntegerRep* x, long y, IntegerRep* r)
       Icheck(r);
       unscale(r->s, r->len, prescale, r->s);
     }
+    r->sgn = xsgn;
   }
   Icheck(r);
   return r;
@@ -1775,7 +1829,7 @@ IntegerRep* bitop(const IntegerRep* x, long y, IntegerRep* r, char op)
   while (u != 0)
   {
 	 tmp[l++] = extract(u);
-	 u = down(u);
+	 u >>= I_SHIFT;
   }
 
   int xl = x->len;
@@ -1856,11 +1910,14 @@ void (setbit)(Integer& x, long b)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    int xl = x.rep ? x.rep->len : 0;
+    IntegerRep *rep = (x.rep) ? x.rep : Icopy_long(0, x.val);
+    int xl = rep->len;
     if (xl <= bw)
-      x.rep = Iresize(x.rep, calc_len(xl, bw+1, 0));
-    x.rep->s[bw] |= (1 << sw);
-    Icheck(x.rep);
+      rep = Iresize(rep, calc_len(xl, bw+1, 0));
+    rep->s[bw] |= (1 << sw);
+    Icheck(rep);
+    x.rep = 0;
+    x.Assign(rep);
   }
 }
 
@@ -1868,26 +1925,25 @@ void clearbit(Integer& x, long b)
 {
   if (b >= 0)
     {
-      if (x.rep == 0)
-	x.rep = &_ZeroRep;
-      else
-	{
-	  int bw = (int) ((unsigned long)b / I_SHIFT);
-	  int sw = (int) ((unsigned long)b % I_SHIFT);
-	  if (x.rep->len > bw)
-	    x.rep->s[bw] &= ~(1 << sw);
-	}
-    Icheck(x.rep);
+      IntegerRep *rep = (x.rep) ? x.rep : Icopy_long(0, x.val);
+      int bw = (int) ((unsigned long)b / I_SHIFT);
+      int sw = (int) ((unsigned long)b % I_SHIFT);
+      if (rep->len > bw)
+	rep->s[bw] &= ~(1 << sw);
+      Icheck(rep);
+      x.rep = 0;
+      x.Assign(rep);
   }
 }
 
 int testbit(const Integer& x, long b)
 {
-  if (x.rep != 0 && b >= 0)
+  if (b >= 0)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    return (bw < x.rep->len && (x.rep->s[bw] & (1 << sw)) != 0);
+    IntegerRepOf rep(x);
+    return (bw < rep->len && (rep->s[bw] & (1 << sw)) != 0);
   }
   else
     return 0;
@@ -2196,7 +2252,7 @@ std::string Itoa(const IntegerRep *x, int base, int width)
 
 std::ostream &operator<<(std::ostream &s, const Integer &y)
 {
-  return s << Itoa(y.rep);
+  return s << Itoa(IntegerRepOf(y));
 }
 
 std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base, int showbase,
@@ -2295,7 +2351,7 @@ std::istream &operator>>(std::istream &s, Integer& y)
 {
   char sgn = 0;
   char ch;
-  y.rep = Icopy_zero(y.rep);
+  y = 0;
 
   do  {
 	 s.get(ch);
@@ -2334,7 +2390,9 @@ std::istream &operator>>(std::istream &s, Integer& y)
 
 int Integer::OK() const
 {
-  if (rep != 0)
+  if (rep == 0)
+    return 1;
+  else
 	 {
       int l = rep->len;
       int s = rep->sgn;
@@ -2361,254 +2419,176 @@ void Integer::error(const char* msg) const
 // The following were moved from the header file to stop BC from squealing
 // endless quantities of warnings
 
-Integer::Integer() :rep(&_ZeroRep) {}
-
-Integer::Integer(IntegerRep* r) :rep(r) {}
-
-Integer::Integer(int y) :rep(Icopy_long(0, (long)y)) {}
-
-Integer::Integer(long y) :rep(Icopy_long(0, y)) {}
-
-Integer::Integer(unsigned long y) :rep(Icopy_ulong(0, y)) {}
-
-Integer::Integer(const Integer&  y) :rep(Icopy(0, y.rep)) {}
+Integer::Integer(IntegerRep* r) :rep(0), val(0) { Assign(r); }
 
-Integer::~Integer() { if (rep && !STATIC_IntegerRep(rep)) delete[] rep; }
+Integer::Integer(unsigned long y) 
+  : rep((y > (unsigned long) LONG_MAX) ? Icopy_ulong(0, y) : 0), val((long) y)
+{ }
 
-Integer &Integer::operator=(const Integer &y)
+void Integer::Assign(IntegerRep *r)
 {
-  rep = Icopy(rep, y.rep);
-  return *this;
+  if (Iislong(r))  {
+    val = Itolong(r);
+    if (!STATIC_IntegerRep(r)) delete[] r;
+    rep = 0;
+  }
+  else {
+    rep = r;
+  }
 }
 
-Integer &Integer::operator=(long y)
+void Integer::Release(void)
 {
-  rep = Icopy_long(rep, y); 
-  return *this;
+  if (!STATIC_IntegerRep(rep)) delete[] rep;
+  rep = 0;
 }
 
 int Integer::initialized() const
 {
-  return rep != 0;
+  return 1;
 }
 
-// procedural versions
+// arbitrary-precision versions of the inlined operations;
+// the result is computed into dest.rep, which is null if dest
+// is held in a long
 
-int compare(const Integer& x, const Integer& y)
+void Integer::AddRep(const Integer &x, const Integer &y, int negatey,
+		     Integer &dest)
 {
-  return compare(x.rep, y.rep);
+  dest.Assign(add(IntegerRepOf(x), 0, IntegerRepOf(y), negatey, dest.rep));
 }
 
-int ucompare(const Integer& x, const Integer& y)
+void Integer::MulRep(const Integer &x, const Integer &y, Integer &dest)
 {
-  return ucompare(x.rep, y.rep);
+  dest.Assign(multiply(IntegerRepOf(x), IntegerRepOf(y), dest.rep));
 }
 
-int compare(const Integer& x, long y)
+int Integer::CompareRep(const Integer &x, const Integer &y)
 {
-  return compare(x.rep, y);
+  return compare(IntegerRepOf(x), IntegerRepOf(y));
 }
 
-int ucompare(const Integer& x, long y)
+int Integer::CompareRep(const Integer &x, long y)
 {
-  return ucompare(x.rep, y);
+  return CompareRep(x, Integer(y));
 }
 
-int compare(long x, const Integer& y)
+double Integer::AsDoubleRep(void) const
 {
-  return -compare(y.rep, x);
+  return Itodouble(IntegerRepOf(*this));
 }
 
-int ucompare(long x, const Integer& y)
-{
-  return -ucompare(y.rep, x);
-}
+// procedural versions
 
-void  add(const Integer& x, const Integer& y, Integer& dest)
+int ucompare(const Integer& x, const Integer& y)
 {
-  dest.rep = add(x.rep, 0, y.rep, 0, dest.rep);
+  return ucompare(IntegerRepOf(x), IntegerRepOf(y));
 }
 
-void  sub(const Integer& x, const Integer& y, Integer& dest)
+int ucompare(const Integer& x, long y)
 {
-  dest.rep = add(x.rep, 0, y.rep, 1, dest.rep);
+  return ucompare(x, Integer(y));
 }
 
-void  mul(const Integer& x, const Integer& y, Integer& dest)
+int ucompare(long x, const Integer& y)
 {
-  dest.rep = multiply(x.rep, y.rep, dest.rep);
+  return -ucompare(y, Integer(x));
 }
 
 void  div(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = div(x.rep, y.rep, dest.rep);
+  // LONG_MIN / -1 is the one quotient of longs which overflows
+  if (!x.rep && !y.rep && y.val != 0 && (y.val != -1 || x.val != LONG_MIN)) {
+    dest.Assign(x.val / y.val);
+  }
+  else {
+    dest.Assign(div(IntegerRepOf(x), IntegerRepOf(y), dest.rep));
+  }
 }
 
 void  mod(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y.rep, dest.rep);
+  if (!x.rep && !y.rep && y.val != 0 && y.val != -1) {
+    dest.Assign(x.val % y.val);
+  }
+  else {
+    dest.Assign(mod(IntegerRepOf(x), IntegerRepOf(y), dest.rep));
+  }
 }
 
 void  lshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 0, dest.rep);
+  dest.Assign(lshift(IntegerRepOf(x), IntegerRepOf(y), 0, dest.rep));
 }
 
 void  rshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 1, dest.rep);
+  dest.Assign(lshift(IntegerRepOf(x), IntegerRepOf(y), 1, dest.rep));
 }
 
 void  pow(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = power(x.rep, Itolong(y.rep), dest.rep); // not incorrect
-}
-
-void  add(const Integer& x, long y, Integer& dest)
-{
-  dest.rep = add(x.rep, 0, y, dest.rep);
-}
-
-void  sub(const Integer& x, long y, Integer& dest)
-{
-  dest.rep = add(x.rep, 0, -y, dest.rep);
-}
-
-void  mul(const Integer& x, long y, Integer& dest)
-{
-  dest.rep = multiply(x.rep, y, dest.rep);
+  dest.Assign(power(IntegerRepOf(x), y.as_long(), dest.rep)); // not incorrect
 }
 
 void  div(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = div(x.rep, y, dest.rep);
+  div(x, Integer(y), dest);
 }
 
 void  mod(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y, dest.rep);
+  mod(x, Integer(y), dest);
 }
 
 
 void  lshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y, dest.rep);
+  dest.Assign(lshift(IntegerRepOf(x), y, dest.rep));
 }
 
 void  rshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, -y, dest.rep);
+  dest.Assign(lshift(IntegerRepOf(x), -y, dest.rep));
 }
 
 void  pow(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = power(x.rep, y, dest.rep);
+  dest.Assign(power(IntegerRepOf(x), y, dest.rep));
 }
 
 void abs(const Integer& x, Integer& dest)
 {
-  dest.rep = abs(x.rep, dest.rep);
+  if (!x.rep && x.val != LONG_MIN) {
+    dest.Assign((x.val < 0) ? -x.val : x.val);
+  }
+  else {
+    dest.Assign(abs(IntegerRepOf(x), dest.rep));
+  }
 }
 
 void negate(const Integer& x, Integer& dest)
 {
-  dest.rep = negate(x.rep, dest.rep);
+  if (!x.rep && x.val != LONG_MIN) {
+    dest.Assign(-x.val);
+  }
+  else {
+    dest.Assign(negate(IntegerRepOf(x), dest.rep));
+  }
 }
 
 void complement(const Integer& x, Integer& dest)
 {
-  dest.rep = Compl(x.rep, dest.rep);
-}
-
-void  add(long x, const Integer& y, Integer& dest)
-{
-  dest.rep = add(y.rep, 0, x, dest.rep);
+  dest.Assign(Compl(IntegerRepOf(x), dest.rep));
 }
 
 void  sub(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 1, x, dest.rep);
-}
-
-void  mul(long x, const Integer& y, Integer& dest)
-{
-  dest.rep = multiply(y.rep, x, dest.rep);
+  sub(Integer(x), y, dest);
 }
 
 // operator versions
 
-bool Integer::operator==(const Integer &y) const
-{
-  return compare(*this, y) == 0; 
-}
-
-bool Integer::operator==(long y) const
-{
-  return compare(*this, y) == 0; 
-}
-
-bool Integer::operator!=(const Integer &y) const
-{
-  return compare(*this, y) != 0; 
-}
-
-bool Integer::operator!=(long y) const
-{
-  return compare(*this, y) != 0; 
-}
-
-bool Integer::operator<(const Integer &y) const
-{
-  return compare(*this, y) <  0; 
-}
-
-bool Integer::operator<(long y) const
-{
-  return compare(*this, y) <  0; 
-}
-
-bool Integer::operator<=(const Integer &y) const
-{
-  return compare(*this, y) <= 0; 
-}
-
-bool Integer::operator<=(long y) const
-{
-  return compare(*this, y) <= 0; 
-}
-
-bool Integer::operator>(const Integer &y) const
-{
-  return compare(*this, y) >  0; 
-}
-
-bool Integer::operator>(long y) const
-{
-  return compare(*this, y) >  0; 
-}
-
-bool Integer::operator>=(const Integer &y) const
-{
-  return compare(*this, y) >= 0; 
-}
-
-bool Integer::operator>=(long y) const
-{
-  return compare(*this, y) >= 0; 
-}
-
-
-Integer &Integer::operator+=(const Integer &y)
-{
-  add(*this, y, *this);
-  return *this;
-}
-
-Integer &Integer::operator+=(long y)
-{
-  add(*this, y, *this);
-  return *this;
-}
 
 void Integer::operator ++ ()
 {
@@ -2616,18 +2596,6 @@ void Integer::operator ++ ()
 }
 
 
-Integer &Integer::operator-=(const Integer &y)
-{
-  sub(*this, y, *this);
-  return *this;
-}
-
-Integer &Integer::operator-=(long y)
-{
-  sub(*this, y, *this);
-  return *this;
-}
-
 void Integer::operator -- ()
 {
   add(*this, -1, *this);
@@ -2635,18 +2603,6 @@ void Integer::operator -- ()
 
 
 
-Integer &Integer::operator*=(const Integer &y)
-{
-  mul(*this, y, *this);
-  return *this;
-}
-
-Integer &Integer::operator*=(long y)
-{
-  mul(*this, y, *this);
-  return *this;
-}
-
 
 Integer &Integer::operator/=(const Integer &y)
 {
@@ -2696,77 +2652,30 @@ void Integer::negate()
 }
 
 
-int sign(const Integer& x)
-{
-  return (x.rep->len == 0) ? 0 : ( (x.rep->sgn == 1) ? 1 : -1 );
-}
-
 int even(const Integer& y)
 {
-  return y.rep->len == 0 || !(y.rep->s[0] & 1);
+  return (y.rep) ? !(y.rep->s[0] & 1) : !(y.val & 1);
 }
 
 int odd(const Integer& y)
 {
-  return y.rep->len > 0 && (y.rep->s[0] & 1);
+  return (y.rep) ? (y.rep->s[0] & 1) : (y.val & 1) != 0;
 }
 
 std::string Itoa(const Integer& y, int base, int width)
 {
-  return Itoa(y.rep, base, width);
+  return Itoa(IntegerRepOf(y), base, width);
 }
 
 
 
 long lg(const Integer& x) 
 {
-  return lg(x.rep);
+  return lg(IntegerRepOf(x));
 }
 
 // constructive operations 
 
-Integer Integer::operator+(const Integer &y) const
-{
-  Integer r;
-  add(*this, y, r);
-  return r;
-}
-
-Integer Integer::operator+(long y) const
-{
-  Integer r;
-  add(*this, y, r);
-  return r;
-}
-
-Integer Integer::operator-(const Integer &y) const
-{
-  Integer r;
-  sub(*this, y, r);
-  return r;
-}
-
-Integer Integer::operator-(long y) const
-{
-  Integer r;
-  sub(*this, y, r);
-  return r;
-}
-
-Integer Integer::operator*(const Integer &y) const
-{
-  Integer r;
-  mul(*this, y, r);
-  return r;
-}
-
-Integer Integer::operator*(long y) const
-{
-  Integer r;
-  mul(*this, y, r);
-  return r;
-}
-
 Integer sqr(const Integer& x) 
 {
   Integer r;
@@ -2871,14 +2780,24 @@ Integer Integer::operator-(void) const
 Integer  atoI(const char* s, int base) 
 {
   Integer r;
-  r.rep = atoIntegerRep(s, base);
+  r.Assign(atoIntegerRep(s, base));
   return r;
 }
 
 Integer  gcd(const Integer& x, const Integer& y)
 {
+  if (!x.rep && !y.rep && x.val != LONG_MIN && y.val != LONG_MIN) {
+    unsigned long a = (x.val < 0) ? -x.val : x.val;
+    unsigned long b = (y.val < 0) ? -y.val : y.val;
+    while (b != 0) {
+      unsigned long t = a % b;
+      a = b;
+      b = t;
+    }
+    return Integer((long) a);
+  }
   Integer r;
-  r.rep = gcd(x.rep, y.rep);
+  r.Assign(gcd(IntegerRepOf(x), IntegerRepOf(y)));
   return r;
 }
 
@@ -24,9 +24,9 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <unordered_set>
 #include "gambit/gambit.h"
-#include "gambit/linalg/lemketab.h"
-#include "gambit/linalg/lhtab.h"
+#include "gambit/linalg/sparselemke.h"
 #include "gambit/nash/lcp.h"
 
 namespace Gambit {
@@ -38,16 +38,24 @@ public:
   Rational maxpay;
   T eps;
   List<GameInfoset> isets1, isets2;
-  List<Gambit::linalg::BFS<T> > m_list;
+  /// The index of each infoset of the player among the reachable
+  /// infosets (zero if unreachable)
+  Array<int> infosetIndex1, infosetIndex2;
+  /// The sequence preceding the first action at each reachable infoset,
+  /// so that the sequences of its actions follow it
+  Array<int> seqOffset1, seqOffset2;
+  std::unordered_set<Gambit::linalg::BFS<T>,
+		     Gambit::linalg::BFSHash<T> > m_bfsSet;
   List<MixedBehaviorProfile<T> > m_equilibria;
 
-  bool AddBFS(const linalg::LemkeTableau<T> &);
+  bool AddBFS(const linalg::SparseLemkeTableau<T> &);
+  void IndexInfosets(const BehaviorSupportProfile &);
 
   int EquilibriumCount(void) const { return m_equilibria.size(); }
 };
 
 template <class T> bool 
-NashLcpBehaviorSolver<T>::Solution::AddBFS(const linalg::LemkeTableau<T> &tableau)
+NashLcpBehaviorSolver<T>::Solution::AddBFS(const linalg::SparseLemkeTableau<T> &tableau)
 {
   Gambit::linalg::BFS<T> cbfs;
   Vector<T> v(tableau.MinRow(), tableau.MaxRow());
@@ -59,12 +67,29 @@ NashLcpBehaviorSolver<T>::Solution::AddBFS(const linalg::LemkeTableau<T> &tablea
     }
   }
 
-  if (!m_list.Contains(cbfs)) {
-    m_list.push_back(cbfs);
-    return true;
+  return m_bfsSet.insert(cbfs).second;
+}
+
+template <class T> void
+NashLcpBehaviorSolver<T>::Solution::IndexInfosets(const BehaviorSupportProfile &p_support)
+{
+  Game game = p_support.GetGame();
+  infosetIndex1 = Array<int>(game->GetPlayer(1)->NumInfosets());
+  infosetIndex2 = Array<int>(game->GetPlayer(2)->NumInfosets());
+  for (int i = 1; i <= infosetIndex1.Length(); infosetIndex1[i++] = 0);
+  for (int i = 1; i <= infosetIndex2.Length(); infosetIndex2[i++] = 0);
+
+  seqOffset1 = Array<int>(isets1.Length());
+  for (int i = 1, snew = 1; i <= isets1.Length(); i++) {
+    infosetIndex1[isets1[i]->GetNumber()] = i;
+    seqOffset1[i] = snew;
+    snew += p_support.NumActions(1, isets1[i]->GetNumber());
   }
-  else {
-    return false;
+  seqOffset2 = Array<int>(isets2.Length());
+  for (int i = 1, snew = 1; i <= isets2.Length(); i++) {
+    infosetIndex2[isets2[i]->GetNumber()] = i;
+    seqOffset2[i] = snew;
+    snew += p_support.NumActions(2, isets2[i]->GetNumber());
   }
 }
 
@@ -73,6 +98,11 @@ NashLcpBehaviorSolver<T>::Solution::AddBFS(const linalg::LemkeTableau<T> &tablea
 // for degenerate problems) for  Linear Complementarity
 // problems, starting from the primary ray.  
 //
+// The sequence form is very sparse: the payoff entries are nonzero
+// only for pairs of sequences which lead to a terminal node together,
+// and the constraint entries only link sequences with their infosets.
+// The matrix and the tableau therefore only store nonzero entries.
+//
 
 template <class T> List<MixedBehaviorProfile<T> > 
 NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
@@ -85,11 +115,12 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
   }
 
   Gambit::linalg::BFS<T> cbfs;
-  int i, j;
+  int i;
   Solution solution;
 
   solution.isets1 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(1));
   solution.isets2 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(2));
+  solution.IndexInfosets(p_support);
 
   int ntot;
   solution.ns1 = p_support.NumSequences(1);
@@ -99,32 +130,27 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
 
   ntot = solution.ns1+solution.ns2+solution.ni1+solution.ni2;
 
-  Matrix<T> A(1,ntot,0,ntot);
+  linalg::SparseMatrix<T> A(1,ntot,0,ntot);
   Vector<T> b(1,ntot);
 
   solution.maxpay = p_support.GetGame()->GetMaxPayoff() + Rational(1);
 
   T prob = (T)1;
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) {
-    b[i] = (T) 0;
-    for (j = A.MinCol(); j <= A.MaxCol(); j++) {
-      A(i,j) = (T) 0; 
-    }
-  }
+  b = (T) 0;
 
   FillTableau(p_support, A, p_support.GetGame()->GetRoot(), prob, 1, 1, 0, 0,
 	      solution);
   for (i = A.MinRow(); i <= A.MaxRow(); i++) { 
-    A(i,0) = -(T) 1;
+    A.Set(i, 0, -(T) 1);
   }
-  A(1,solution.ns1+solution.ns2+1) = (T) 1;
-  A(solution.ns1+solution.ns2+1,1) = -(T) 1;
-  A(solution.ns1+1,solution.ns1+solution.ns2+solution.ni1+1) = (T) 1;
-  A(solution.ns1+solution.ns2+solution.ni1+1,solution.ns1+1) = -(T) 1;
+  A.Set(1, solution.ns1+solution.ns2+1, (T) 1);
+  A.Set(solution.ns1+solution.ns2+1, 1, -(T) 1);
+  A.Set(solution.ns1+1, solution.ns1+solution.ns2+solution.ni1+1, (T) 1);
+  A.Set(solution.ns1+solution.ns2+solution.ni1+1, solution.ns1+1, -(T) 1);
   b[solution.ns1+solution.ns2+1] = -(T)1;
   b[solution.ns1+solution.ns2+solution.ni1+1] = -(T)1;
 
-  linalg::LemkeTableau<T> tab(A,b);
+  linalg::SparseLemkeTableau<T> tab(A,b);
   solution.eps = tab.Epsilon();
   
   try {
@@ -171,8 +197,8 @@ NashLcpBehaviorSolver<T>::Solve(const BehaviorSupportProfile &p_support) const
 //
 template <class T> void
 NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
-				   int j, linalg::LemkeTableau<T> &B, int depth,
-				   Matrix<T> &A,
+				   int j, linalg::SparseLemkeTableau<T> &B, int depth,
+				   linalg::SparseMatrix<T> &A,
 				   Solution &p_solution) const
 {
   if (m_maxDepth != 0 && depth > m_maxDepth) {
@@ -188,9 +214,10 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
   for (int i = B.MinRow(); i <= B.MaxRow() && !newsol; i++) {
     if (i == j) continue;
 
-    linalg::LemkeTableau<T> BCopy(B);
-    A(i,0) = -small_num;
-    BCopy.Refactor();
+    // The covering column is not in the basis here, so the tableau
+    // picks up the change to it without being refactored
+    linalg::SparseLemkeTableau<T> BCopy(B);
+    A.Set(i, 0, -small_num);
 
     int missing;
     if (depth == 0) {
@@ -222,9 +249,8 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
       // gout << ": Dead End";
     }
       
-    A(i,0) = (T) -1;
+    A.Set(i, 0, (T) -1);
     if (newsol) {
-      BCopy.Refactor();
       AllLemke(p_support, i, BCopy, depth+1, A, p_solution);
     }
   }
@@ -232,7 +258,7 @@ NashLcpBehaviorSolver<T>::AllLemke(const BehaviorSupportProfile &p_support,
 
 template <class T>
 void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_support, 
-					Matrix<T> &A,
+					linalg::SparseMatrix<T> &A,
 					const GameNode &n, T prob,
 					int s1, int s2, int i1, int i2,
 					Solution &p_solution) const
@@ -244,10 +270,10 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
 
   GameOutcome outcome = n->GetOutcome();
   if (outcome) {
-    A(s1,ns1+s2) = Rational(A(s1,ns1+s2)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(1) - p_solution.maxpay);
-    A(ns1+s2,s1) = Rational(A(ns1+s2,s1)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(2) - p_solution.maxpay);
+    A.Set(s1, ns1+s2, Rational(A(s1,ns1+s2)) +
+	  Rational(prob) * (outcome->GetPayoff<Rational>(1) - p_solution.maxpay));
+    A.Set(ns1+s2, s1, Rational(A(ns1+s2,s1)) +
+	  Rational(prob) * (outcome->GetPayoff<Rational>(2) - p_solution.maxpay));
   }
   if (n->GetInfoset()) {
     if (n->GetPlayer()->IsChance()) {
@@ -260,32 +286,24 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
     }
     int pl = n->GetPlayer()->GetNumber();
     if (pl==1) {
-      i1=p_solution.isets1.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i1; i++) {
-	snew+=p_support.NumActions(p_solution.isets1[i]->GetPlayer()->GetNumber(),
-				   p_solution.isets1[i]->GetNumber());
-      }
-      A(s1,ns1+ns2+i1+1) = -(T)1;
-      A(ns1+ns2+i1+1,s1) = (T)1;
+      i1=p_solution.infosetIndex1[n->GetInfoset()->GetNumber()];
+      snew=p_solution.seqOffset1[i1];
+      A.Set(s1, ns1+ns2+i1+1, -(T)1);
+      A.Set(ns1+ns2+i1+1, s1, (T)1);
       for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(snew+i,ns1+ns2+i1+1) = (T)1;
-	A(ns1+ns2+i1+1,snew+i) = -(T)1;
+	A.Set(snew+i, ns1+ns2+i1+1, (T)1);
+	A.Set(ns1+ns2+i1+1, snew+i, -(T)1);
 	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,snew+i,s2,i1,i2, p_solution);
       }
     }
     if(pl==2) {
-      i2=p_solution.isets2.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i2; i++) {
-	snew+=p_support.NumActions(p_solution.isets2[i]->GetPlayer()->GetNumber(),
-				   p_solution.isets2[i]->GetNumber());
-      }
-      A(ns1+s2,ns1+ns2+ni1+i2+1) = -(T)1;
-      A(ns1+ns2+ni1+i2+1,ns1+s2) = (T)1;
+      i2=p_solution.infosetIndex2[n->GetInfoset()->GetNumber()];
+      snew=p_solution.seqOffset2[i2];
+      A.Set(ns1+s2, ns1+ns2+ni1+i2+1, -(T)1);
+      A.Set(ns1+ns2+ni1+i2+1, ns1+s2, (T)1);
       for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(ns1+snew+i,ns1+ns2+ni1+i2+1) = (T)1;
-	A(ns1+ns2+ni1+i2+1,ns1+snew+i) = -(T)1;
+	A.Set(ns1+snew+i, ns1+ns2+ni1+i2+1, (T)1);
+	A.Set(ns1+ns2+ni1+i2+1, ns1+snew+i, -(T)1);
 	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,s1,snew+i,i1,i2, p_solution);
       }
     }
@@ -296,7 +314,7 @@ void NashLcpBehaviorSolver<T>::FillTableau(const BehaviorSupportProfile &p_suppo
 
 template <class T> void
 NashLcpBehaviorSolver<T>::GetProfile(const BehaviorSupportProfile &p_support,
-				     const linalg::LemkeTableau<T> &tab, 
+				     const linalg::SparseLemkeTableau<T> &tab, 
 				     MixedBehaviorProfile<T> &v, 
 				     const Vector<T> &sol,
 				     const GameNode &n, int s1, int s2,
@@ -315,11 +333,8 @@ NashLcpBehaviorSolver<T>::GetProfile(const BehaviorSupportProfile &p_support,
       }
     }
     else if (pl == 1) {
-      int inf = p_solution.isets1.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(1, p_solution.isets1[i]->GetNumber()); 
-      }
+      int inf = p_solution.infosetIndex1[iset];
+      int snew = p_solution.seqOffset1[inf];
       
       for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
 	v(pl,inf,i) = (T) 0;
@@ -340,11 +355,8 @@ NashLcpBehaviorSolver<T>::GetProfile(const BehaviorSupportProfile &p_support,
       }
     }
     else if (pl == 2) { 
-      int inf = p_solution.isets2.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(2, p_solution.isets2[i]->GetNumber()); 
-      }
+      int inf = p_solution.infosetIndex2[iset];
+      int snew = p_solution.seqOffset2[inf];
 
       for (int i = 1; i<= p_support.NumActions(pl, iset); i++) {
 	v(pl,inf,i) = (T) 0;
@@ -23,6 +23,11 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 #include "gambit/gambit.h"
 #include "gambit/linalg/lhtab.h"
@@ -112,29 +117,42 @@ template <class T> Vector<T> Make_b2(const Game &p_game)
   return b2;
 }
 
+//
+// Copies of floating-point tableaux share the factorization of the basis
+// with the original; refactoring makes a copy independent of it, so that
+// it can be pivoted in another thread.  Rational tableaux are always
+// independent of the tableau they are copied from.
+//
+void DetachTableau(linalg::LHTableau<double> &p_tableau)
+{ p_tableau.Refactor(); }
+
+void DetachTableau(linalg::LHTableau<Rational> &)
+{ }
+
 }  // end anonymous namespace
   
 
 template <class T>
 class NashLcpStrategySolver<T>::Solution {
 public:
-  List<Gambit::linalg::BFS<T> > m_bfsList;
+  std::unordered_set<Gambit::linalg::BFS<T>,
+		     Gambit::linalg::BFSHash<T> > m_bfsSet;
   List<MixedStrategyProfile<T> > m_equilibria;
 
   bool Contains(const Gambit::linalg::BFS<T> &p_bfs) const
-  { return m_bfsList.Contains(p_bfs); }
+  { return m_bfsSet.count(p_bfs) > 0; }
   void push_back(const Gambit::linalg::BFS<T> &p_bfs)
-  { m_bfsList.push_back(p_bfs); }
+  { m_bfsSet.insert(p_bfs); }
 
   int EquilibriumCount(void) const { return m_equilibria.size(); }
 };
   
 //
 // Function called when a CBFS is encountered.
-// If it is not already in the list p_list, it is added.
+// If it is not already in the set of visited bases, it is added.
 // The corresponding equilibrium is computed and output.
 // Returns 'true' if the CBFS is new; 'false' if it already appears in the
-// list.
+// set.
 //
 template <class T> bool
 NashLcpStrategySolver<T>::OnBFS(const Game &p_game,
@@ -227,6 +245,75 @@ NashLcpStrategySolver<T>::AllLemke(const Game &p_game,
   }
 }
 
+//
+// AllLemkeParallel visits the same graph of Lemke paths as AllLemke,
+// but breadth-first, one level of depth at a time.  The paths leaving
+// all the bases at one level are followed concurrently, using
+// m_numThreads threads.  The bases reached are then checked against
+// those already visited, and reported, in a fixed order, so that the
+// output does not depend on the number of threads.  The depth of a
+// basis here is the length of the shortest sequence of paths reaching it.
+//
+template <class T> void 
+NashLcpStrategySolver<T>::AllLemkeParallel(const Game &p_game,
+					   linalg::LHTableau<T> &B,
+					   Solution &p_solution) const
+{
+  typedef Gambit::shared_ptr<linalg::LHTableau<T> > TableauPtr;
+
+  // The bases at the current level, and the labels by which they were reached
+  std::vector<TableauPtr> level(1, TableauPtr(new linalg::LHTableau<T>(B)));
+  std::vector<int> labels(1, 0);
+
+  for (int depth = 1;
+       !level.empty() && (m_maxDepth == 0 || depth <= m_maxDepth); depth++) {
+    // Each task follows the path from one basis for one missing label
+    std::vector<int> taskBasis, taskLabel;
+    for (int b = 0; b < (int) level.size(); b++) {
+      for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
+	if (i != labels[b]) {
+	  taskBasis.push_back(b);
+	  taskLabel.push_back(i);
+	}
+      }
+    }
+
+    std::vector<TableauPtr> reached(taskBasis.size());
+    std::vector<std::exception_ptr> errors(taskBasis.size());
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < m_numThreads && t < (int) taskBasis.size(); t++) {
+      workers.push_back(std::thread([&]() {
+	    for (int k = next++; k < (int) taskBasis.size(); k = next++) {
+	      try {
+		reached[k] = new linalg::LHTableau<T>(*level[taskBasis[k]]);
+		DetachTableau(*reached[k]);
+		reached[k]->LemkePath(taskLabel[k]);
+	      }
+	      catch (...) {
+		errors[k] = std::current_exception();
+	      }
+	    }
+	  }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+      workers[t].join();
+    }
+
+    level.clear();
+    labels.clear();
+    for (int k = 0; k < (int) reached.size(); k++) {
+      if (errors[k]) {
+	std::rethrow_exception(errors[k]);
+      }
+      if (OnBFS(p_game, *reached[k], p_solution)) {
+	level.push_back(reached[k]);
+	labels.push_back(taskLabel[k]);
+      }
+    }
+  }
+}
+
 template <class T> List<MixedStrategyProfile<T> > 
 NashLcpStrategySolver<T>::Solve(const Game &p_game) const
 {
@@ -245,7 +332,10 @@ NashLcpStrategySolver<T>::Solve(const Game &p_game) const
     Vector<T> b2 = Make_b2<T>(p_game);
     linalg::LHTableau<T> B(A1, A2, b1, b2);
 
-    if (m_stopAfter != 1) {
+    if (m_stopAfter != 1 && m_numThreads > 1) {
+      AllLemkeParallel(p_game, B, solution);
+    }
+    else if (m_stopAfter != 1) {
       AllLemke(p_game, 0, B, solution, 0);
     }
     else  {
@@ -25,8 +25,6 @@
 using namespace Gambit;
 using namespace Gambit::linalg;
 
-template class EtaMatrix<double>;
 template class LUdecomp<double>;
 
-template class EtaMatrix<Rational>;
 template class LUdecomp<Rational>;
@@ -0,0 +1,30 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: library/src/linalg/sparselemke.cc
+// Instantiation of Lemke tableau for sparse matrices
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include "gambit/linalg/sparselemke.imp"
+
+using namespace Gambit::linalg;
+
+template class SparseMatrix<double>;
+template class SparseMatrix<Gambit::Rational>;
+template class SparseLemkeTableau<double>;
+template class SparseLemkeTableau<Gambit::Rational>;
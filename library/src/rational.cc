@@ -537,60 +537,68 @@ Rational Rational::operator/(const Rational &y) const
 }
 
 
-template<>
-Rational lexical_cast(const std::string &f)
+//
+// Returns the next character of the text, reading the position just
+// past the end (and any beyond it) as '\0'
+//
+static inline char NextChar(const char *&p_pos, const char *p_end)
 {
+  return (p_pos < p_end) ? *p_pos++ : '\0';
+}
+
+Rational TextToRational(const char *p_begin, const char *p_end)
+{
+  const char *pos = p_begin;
   char ch = ' ';
   int sign = 1;
-  unsigned int index = 0, length = f.length();
   Integer num = 0, denom = 1;
 
-  while (isspace(ch) && index<=length) {
-    ch = f[index++];
+  while (isspace(ch)) {
+    ch = NextChar(pos, p_end);
   }
 
-  if (ch == '-' && index<=length)  {
+  if (ch == '-')  {
     sign = -1;
-    ch=f[index++];
+    ch = NextChar(pos, p_end);
   }
 
-  while (ch >= '0' && ch <= '9' && index<=length)   {
+  while (ch >= '0' && ch <= '9')   {
     num *= 10;
     num += (int) (ch - '0');
-    ch=f[index++];
+    ch = NextChar(pos, p_end);
   }
 
   if (ch == '/')  {
     denom = 0;
-    ch=f[index++];
-    while (ch >= '0' && ch <= '9' && index<=length)  {
+    ch = NextChar(pos, p_end);
+    while (ch >= '0' && ch <= '9')  {
       denom *= 10;
       denom += (int) (ch - '0');
-      ch=f[index++];
+      ch = NextChar(pos, p_end);
     }
   }
   else if (ch == '.')  {
     denom = 1;
-    ch=f[index++];
-    while (ch >= '0' && ch <= '9' && index<=length)  {
+    ch = NextChar(pos, p_end);
+    while (ch >= '0' && ch <= '9')  {
       denom *= 10;
       num *= 10;
       num += (int) (ch - '0');
-      ch=f[index++];
+      ch = NextChar(pos, p_end);
     }
     
     if (ch == 'e' || ch == 'E') {
       int expsign = 1;
       Integer exponent = 0;
-      ch = f[index++];
+      ch = NextChar(pos, p_end);
       if (ch == '-')  {
 	expsign = -1;
-	ch = f[index++];
+	ch = NextChar(pos, p_end);
       }
-      while (ch >= '0' && ch <= '9' && index <= length) {
+      while (ch >= '0' && ch <= '9') {
 	exponent *= 10;
 	exponent += (int) (ch - '0');
-	ch = f[index++];
+	ch = NextChar(pos, p_end);
       }
       if (exponent * expsign > 0) {
 	while (exponent > 0) {
@@ -609,15 +617,15 @@ Rational lexical_cast(const std::string &f)
   else if (ch == 'e' || ch == 'E') {
     int expsign = 1;
     Integer exponent = 0;
-    ch = f[index++];
+    ch = NextChar(pos, p_end);
     if (ch == '-')  {
       expsign = -1;
-      ch = f[index++];
+      ch = NextChar(pos, p_end);
     }
-    while (ch >= '0' && ch <= '9' && index <= length) {
+    while (ch >= '0' && ch <= '9') {
       exponent *= 10;
       exponent += (int) (ch - '0');
-      ch = f[index++];
+      ch = NextChar(pos, p_end);
     }
     if (exponent * expsign > 0) {
       while (exponent > 0) {
@@ -640,4 +648,10 @@ Rational lexical_cast(const std::string &f)
   return Rational(num * sign, denom);
 }
 
+template<>
+Rational lexical_cast(const std::string &f)
+{
+  return TextToRational(f.data(), f.data() + f.length());
+}
+
 }  // end namespace Gambit
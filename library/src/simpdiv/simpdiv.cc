@@ -26,6 +26,208 @@
 namespace Gambit {
 namespace Nash {
 
+//-------------------------------------------------------------------------
+//                 NashSimpdivStrategySolver::PayoffTable
+//-------------------------------------------------------------------------
+
+class NashSimpdivStrategySolver::PayoffTable {
+public:
+  /// The largest number of contingencies for which a table is built
+  static const long MAX_CONTINGENCIES = 1 << 20;
+
+  PayoffTable(const Game &p_game);
+
+  /// Returns whether the game is small enough to tabulate its payoffs
+  static bool IsTabulable(const Game &p_game);
+
+  /// The common denominator of the payoffs
+  const Integer &Denominator(void) const { return m_denominator; }
+  /// The number of contingencies in which the entry p_index of a
+  /// strategy profile takes part
+  long NumContingencies(int p_index) const
+  { return m_numContingencies / m_numStrategies[m_player[p_index]]; }
+  long NumContingencies(void) const { return m_numContingencies; }
+
+  /// Sets p_payoffs to the scaled payoffs of the strategies at the
+  /// point p_grid, all of whose entries are multiplied by the same
+  /// integer.  The payoffs are then multiplied by the same integer to
+  /// the power of the number of players less one, and by Denominator().
+  void ComputePayoffs(const Array<Integer> &p_grid,
+		      Array<Integer> &p_payoffs) const;
+  /// Adds to p_payoffs the change in the scaled payoffs when entry
+  /// p_index of p_grid is increased by p_delta
+  void AddPayoffs(const Array<Integer> &p_grid, int p_index,
+		  const Integer &p_delta, Array<Integer> &p_payoffs) const;
+
+private:
+  int m_numPlayers;
+  long m_numContingencies;
+  Integer m_denominator;
+  /// The number of strategies of each player, the offset of each player's
+  /// first strategy in a strategy profile, and the stride of each
+  /// player's strategies in the index of a contingency
+  Array<int> m_numStrategies, m_offset;
+  Array<long> m_stride;
+  /// The player and strategy of each entry of a strategy profile
+  Array<int> m_player, m_strategy;
+  /// The scaled payoffs to each player, indexed by contingency
+  Array<Array<Integer> > m_payoffs;
+
+  /// Adds to p_payoffs, for each player other than p_fixed, the payoff
+  /// in each contingency in which p_fixed plays p_fixedStrategy times
+  /// the product of the other players' entries of p_grid.  If p_fixed is
+  /// zero, all contingencies are summed, and the entries of p_grid are
+  /// used for every player.
+  void Accumulate(const Array<Integer> &p_grid, int p_fixed,
+		  int p_fixedStrategy, const Integer &p_factor,
+		  Array<Integer> &p_payoffs) const;
+};
+
+bool NashSimpdivStrategySolver::PayoffTable::IsTabulable(const Game &p_game)
+{
+  long size = 1;
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    size *= p_game->GetPlayer(pl)->NumStrategies();
+    if (size > MAX_CONTINGENCIES)  return false;
+  }
+  return true;
+}
+
+NashSimpdivStrategySolver::PayoffTable::PayoffTable(const Game &p_game)
+  : m_numPlayers(p_game->NumPlayers()), m_numContingencies(1),
+    m_denominator(1),
+    m_numStrategies(m_numPlayers), m_offset(m_numPlayers),
+    m_stride(m_numPlayers), m_payoffs(m_numPlayers)
+{
+  int length = 0;
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    m_numStrategies[pl] = p_game->GetPlayer(pl)->NumStrategies();
+    m_offset[pl] = length;
+    m_stride[pl] = m_numContingencies;
+    length += m_numStrategies[pl];
+    m_numContingencies *= m_numStrategies[pl];
+  }
+  m_player = Array<int>(length);
+  m_strategy = Array<int>(length);
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    for (int st = 1; st <= m_numStrategies[pl]; st++) {
+      m_player[m_offset[pl] + st] = pl;
+      m_strategy[m_offset[pl] + st] = st;
+    }
+  }
+
+  Array<Array<Rational> > payoffs(m_numPlayers);
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    payoffs[pl] = Array<Rational>(m_numContingencies);
+    m_payoffs[pl] = Array<Integer>(m_numContingencies);
+  }
+  for (StrategyProfileIterator iter(p_game); !iter.AtEnd(); iter++) {
+    long index = 1;
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      index += ((*iter)->GetStrategy(pl)->GetNumber() - 1) * m_stride[pl];
+    }
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      payoffs[pl][index] = (*iter)->GetPayoff(pl);
+      m_denominator = lcm(payoffs[pl][index].denominator(), m_denominator);
+    }
+  }
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    for (long index = 1; index <= m_numContingencies; index++) {
+      m_payoffs[pl][index] = payoffs[pl][index].numerator() *
+	(m_denominator / payoffs[pl][index].denominator());
+    }
+  }
+}
+
+void 
+NashSimpdivStrategySolver::PayoffTable::Accumulate(const Array<Integer> &p_grid,
+						   int p_fixed,
+						   int p_fixedStrategy,
+						   const Integer &p_factor,
+						   Array<Integer> &p_payoffs) const
+{
+  // Visits the contingencies as an odometer, player 1 fastest, holding
+  // the fixed player's strategy.  The product of the other players'
+  // factors is formed from the products of the factors before and after
+  // each player, unless some factor is zero.
+  Array<int> profile(m_numPlayers);
+  Array<Integer> factor(m_numPlayers), before(m_numPlayers + 1),
+    after(m_numPlayers + 1);
+  long index = 1;
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    profile[pl] = (pl == p_fixed) ? p_fixedStrategy : 1;
+    index += (profile[pl] - 1) * m_stride[pl];
+  }
+
+  while (true) {
+    int zeros = 0, zero = 0;
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      factor[pl] = (pl == p_fixed) ? p_factor : 
+	p_grid[m_offset[pl] + profile[pl]];
+      if (factor[pl] == 0) {
+	zeros++;
+	zero = pl;
+      }
+    }
+    if (zeros == 1 && zero != p_fixed) {
+      Integer product(1);
+      for (int pl = 1; pl <= m_numPlayers; pl++) {
+	if (pl != zero)  product *= factor[pl];
+      }
+      p_payoffs[m_offset[zero] + profile[zero]] += 
+	m_payoffs[zero][index] * product;
+    }
+    else if (zeros == 0) {
+      before[1] = 1;
+      after[m_numPlayers] = 1;
+      for (int pl = 1; pl < m_numPlayers; pl++) {
+	before[pl + 1] = before[pl] * factor[pl];
+      }
+      for (int pl = m_numPlayers; pl > 1; pl--) {
+	after[pl - 1] = after[pl] * factor[pl];
+      }
+      for (int pl = 1; pl <= m_numPlayers; pl++) {
+	if (pl == p_fixed)  continue;
+	p_payoffs[m_offset[pl] + profile[pl]] += 
+	  m_payoffs[pl][index] * before[pl] * after[pl];
+      }
+    }
+
+    int pl = 1;
+    for (; pl <= m_numPlayers; pl++) {
+      if (pl == p_fixed)  continue;
+      if (profile[pl] < m_numStrategies[pl]) {
+	profile[pl]++;
+	index += m_stride[pl];
+	break;
+      }
+      index -= (profile[pl] - 1) * m_stride[pl];
+      profile[pl] = 1;
+    }
+    if (pl > m_numPlayers)  return;
+  }
+}
+
+void 
+NashSimpdivStrategySolver::PayoffTable::ComputePayoffs(const Array<Integer> &p_grid,
+						       Array<Integer> &p_payoffs) const
+{
+  for (int i = 1; i <= p_payoffs.Length(); i++) {
+    p_payoffs[i] = 0;
+  }
+  Accumulate(p_grid, 0, 0, Integer(1), p_payoffs);
+}
+
+void 
+NashSimpdivStrategySolver::PayoffTable::AddPayoffs(const Array<Integer> &p_grid,
+						   int p_index, 
+						   const Integer &p_delta,
+						   Array<Integer> &p_payoffs) const
+{
+  Accumulate(p_grid, m_player[p_index], m_strategy[p_index], p_delta,
+	     p_payoffs);
+}
+
 //-------------------------------------------------------------------------
 //          NashSimpdivStrategySolver: Private member functions
 //-------------------------------------------------------------------------
@@ -37,10 +239,11 @@ inline GameStrategy GetStrategy(const Game &game, int pl, int st)
 
 Rational 
 NashSimpdivStrategySolver::Simplex(MixedStrategyProfile<Rational> &y,
-				   const Rational &d) const
+				   const Rational &d,
+				   const PayoffTable *p_table) const
 {
   Game game = y.GetGame();
-  State state;
+  State state(p_table);
   state.d = d;
   Array<int> nstrats(game->NumStrategies());
   Array<int> ylabel(2);
@@ -387,6 +590,47 @@ int NashSimpdivStrategySolver::get_c(int j, int h, int nstrats,
   return (hh > nstrats) ? 1 : hh;
 }
 
+void 
+NashSimpdivStrategySolver::State::updatePayoffs(const MixedStrategyProfile<Rational> &yy)
+{
+  if (lastY.Length() == 0) {
+    gridSize = (Rational(1) / d).numerator();
+    scale = Rational(1) / Rational(table->Denominator());
+    for (int i = 1; i <= yy.GetGame()->NumPlayers(); i++) {
+      scale *= d;
+    }
+    lastY = Array<Rational>(yy.MixedProfileLength());
+    grid = Array<Integer>(yy.MixedProfileLength());
+    payoffs = Array<Integer>(yy.MixedProfileLength());
+  }
+  else {
+    // Each changed coordinate costs a pass over the contingencies in
+    // which it takes part; if these together outnumber all the
+    // contingencies, all payoffs are computed afresh
+    long cost = 0;
+    for (int k = 1; k <= lastY.Length() && cost < table->NumContingencies();
+	 k++) {
+      if (yy[k] != lastY[k])  cost += table->NumContingencies(k);
+    }
+    if (cost < table->NumContingencies()) {
+      for (int k = 1; k <= lastY.Length(); k++) {
+	if (yy[k] == lastY[k])  continue;
+	lastY[k] = yy[k];
+	Integer coordinate = (yy[k] * Rational(gridSize)).numerator();
+	table->AddPayoffs(grid, k, coordinate - grid[k], payoffs);
+	grid[k] = coordinate;
+      }
+      return;
+    }
+  }
+
+  for (int k = 1; k <= lastY.Length(); k++) {
+    lastY[k] = yy[k];
+    grid[k] = (yy[k] * Rational(gridSize)).numerator();
+  }
+  table->ComputePayoffs(grid, payoffs);
+}
+
 Rational 
 NashSimpdivStrategySolver::State::getlabel(MixedStrategyProfile<Rational> &yy,
 					   Array<int> &ylabel,
@@ -396,23 +640,52 @@ NashSimpdivStrategySolver::State::getlabel(MixedStrategyProfile<Rational> &yy,
   ylabel[1] = 1;
   ylabel[2] = 1;
   
-  for (int i = 1; i <= yy.GetGame()->NumPlayers(); i++) {
-    GamePlayer player = yy.GetGame()->Players()[i];
-    Rational payoff = 0;
-    Rational maxval = -1000000;
-    int jj = 0;
-    for (int j = 1; j <= player->Strategies().size(); j++) {
-      pay = yy.GetPayoff(player->Strategies()[j]);
-      payoff += yy[player->Strategies()[j]] * pay;
-      if (pay > maxval) {
-	maxval = pay;
-	jj = j;
+  if (table) {
+    // For y = d g the payoff to a strategy is d^(n-1) p / D, for p its
+    // scaled payoff; the gain of a player's best strategy over y is then
+    // (d^n / D) (p_max / d - sum_j g_j p_j), for n players and D the
+    // denominator of the table.
+    updatePayoffs(yy);
+    Integer maxgain;
+    for (int i = 1, k = 1; i <= yy.GetGame()->NumPlayers(); i++) {
+      int nstrats = yy.GetGame()->GetPlayer(i)->NumStrategies();
+      Integer payoff(0), maxval(payoffs[k]);
+      int jj = 1;
+      for (int j = 1; j <= nstrats; j++, k++) {
+	payoff += grid[k] * payoffs[k];
+	if (payoffs[k] > maxval) {
+	  maxval = payoffs[k];
+	  jj = j;
+	}
+      }
+      Integer gain = gridSize * maxval - payoff;
+      if (i == 1 || gain > maxgain) {
+	maxgain = gain;
+	ylabel[1] = i;
+	ylabel[2] = jj;
       }
     }
-    if (maxval - payoff > maxz) {
-      maxz = maxval - payoff;
-      ylabel[1] = i;
-      ylabel[2] = jj;
+    maxz = Rational(maxgain) * scale;
+  }
+  else {
+    for (int i = 1; i <= yy.GetGame()->NumPlayers(); i++) {
+      GamePlayer player = yy.GetGame()->Players()[i];
+      Rational payoff = 0;
+      Rational maxval = -1000000;
+      int jj = 0;
+      for (int j = 1; j <= player->Strategies().size(); j++) {
+	pay = yy.GetPayoff(player->Strategies()[j]);
+	payoff += yy[player->Strategies()[j]] * pay;
+	if (pay > maxval) {
+	  maxval = pay;
+	  jj = j;
+	}
+      }
+      if (maxval - payoff > maxz) {
+	maxz = maxval - payoff;
+	ylabel[1] = i;
+	ylabel[2] = jj;
+      }
     }
   }
   if (maxz < bestz) {
@@ -451,6 +724,10 @@ NashSimpdivStrategySolver::Solve(const MixedStrategyProfile<Rational> &p_start)
   Rational d = Rational(1, k);
     
   MixedStrategyProfile<Rational> y(p_start);
+  shared_ptr<PayoffTable> table;
+  if (PayoffTable::IsTabulable(y.GetGame())) {
+    table = new PayoffTable(y.GetGame());
+  }
   if (m_verbose) {
     this->m_onEquilibrium->Render(y, "start");
   }
@@ -458,7 +735,7 @@ NashSimpdivStrategySolver::Solve(const MixedStrategyProfile<Rational> &p_start)
   while (true) {
     const double TOL = 1.0e-10;
     d /= m_gridResize;
-    Rational maxz = Simplex(y, d);
+    Rational maxz = Simplex(y, d, table.get());
     
     if (m_verbose) {
       this->m_onEquilibrium->Render(y, lexical_cast<std::string>(d));
@@ -41,8 +41,7 @@ inline Game NewTable(Array<int> *dim)
 
 Game ReadGame(char *fn) throw (InvalidFileException)
 { 
-  std::ifstream f(fn);
-  return ReadGame(f);
+  return ReadGameFile(fn);
 }
 
 Game ParseGame(char *s) throw (InvalidFileException)
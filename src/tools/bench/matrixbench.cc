@@ -0,0 +1,417 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/matrixbench.cc
+// Microbenchmark of dense matrix and path-following workloads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+//
+// Runs two workloads twice each: once on Gambit::Matrix, which stores
+// its entries contiguously and offers unchecked row and column views,
+// and once on a matrix which stores each row in a separate allocation
+// and checks every index, in the way RectArray always stored its entries
+// before it had the contiguous form.
+//
+// The matrix workload does matrix-vector products, elementwise sums and
+// Gauss-Jordan pivots.  The path workload repeats the inner loop of the
+// logit path tracer: a QR decomposition of the Jacobian by Givens
+// rotations, followed by a Newton step.  Both runs of each workload must
+// produce the same results.
+//
+
+#include <cstdlib>
+#include <unistd.h>
+#include <getopt.h>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "gambit/gambit.h"
+
+using namespace Gambit;
+
+//
+// A matrix with each row held in its own allocation, indexed through
+// a table of row pointers
+//
+class RowMatrix {
+private:
+  int m_rows, m_cols;
+  double **m_data;
+
+public:
+  RowMatrix(int p_rows, int p_cols)
+    : m_rows(p_rows), m_cols(p_cols), m_data(new double *[p_rows] - 1)
+  {
+    for (int i = 1; i <= m_rows; i++) {
+      m_data[i] = new double[m_cols] - 1;
+      for (int j = 1; j <= m_cols; j++) {
+	m_data[i][j] = 0.0;
+      }
+    }
+  }
+  RowMatrix(const RowMatrix &p_matrix)
+    : m_rows(p_matrix.m_rows), m_cols(p_matrix.m_cols),
+      m_data(new double *[p_matrix.m_rows] - 1)
+  {
+    for (int i = 1; i <= m_rows; i++) {
+      m_data[i] = new double[m_cols] - 1;
+      for (int j = 1; j <= m_cols; j++) {
+	m_data[i][j] = p_matrix.m_data[i][j];
+      }
+    }
+  }
+  ~RowMatrix()
+  {
+    for (int i = 1; i <= m_rows; i++) {
+      delete [] (m_data[i] + 1);
+    }
+    delete [] (m_data + 1);
+  }
+
+  int NumRows(void) const { return m_rows; }
+  int NumColumns(void) const { return m_cols; }
+
+  double &operator()(int r, int c)
+  {
+    if (r < 1 || r > m_rows || c < 1 || c > m_cols)  throw IndexException();
+    return m_data[r][c];
+  }
+  double operator()(int r, int c) const
+  {
+    if (r < 1 || r > m_rows || c < 1 || c > m_cols)  throw IndexException();
+    return m_data[r][c];
+  }
+
+  void CMultiply(const Vector<double> &in, Vector<double> &out) const
+  {
+    for (int i = 1; i <= m_rows; i++) {
+      double sum = 0.0;
+      const double *src1 = m_data[i] + 1, *src2 = &in[1];
+      int j = m_cols;
+      while (j--)
+	sum += *(src1++) * *(src2++);
+      out[i] = sum;
+    }
+  }
+
+  RowMatrix &operator+=(const RowMatrix &M)
+  {
+    for (int i = 1; i <= m_rows; i++) {
+      double *dst = m_data[i] + 1;
+      const double *src = M.m_data[i] + 1;
+      int j = m_cols;
+      while (j--)
+	*(dst++) += *(src++);
+    }
+    return *this;
+  }
+
+  void Pivot(int row, int col)
+  {
+    if (m_data[row][col] == 0.0)  throw ZeroDivideException();
+    double mult = 1.0 / m_data[row][col];
+    for (int j = 1; j <= m_cols; j++)
+      m_data[row][j] *= mult;
+    for (int i = 1; i <= m_rows; i++) {
+      if (i != row) {
+	mult = m_data[i][col];
+	double *src = m_data[row] + 1, *dst = m_data[i] + 1;
+	int j = m_cols;
+	while (j--)
+	  *(dst++) -= *(src++) * mult;
+      }
+    }
+  }
+
+  void MakeIdent(void)
+  {
+    for (int i = 1; i <= m_rows; i++)
+      for (int j = 1; j <= m_cols; j++)
+	(*this)(i, j) = (i == j) ? 1.0 : 0.0;
+  }
+};
+
+//
+// The matrix workload
+//
+template <class M> void
+RunMatrix(M &p_matrix, const M &p_increment, int p_iterations,
+	  Vector<double> &p_result)
+{
+  int n = p_matrix.NumRows();
+  Vector<double> x(n), y(n);
+  for (int i = 1; i <= n; i++) {
+    x[i] = 1.0 / i;
+  }
+  for (int k = 0; k < p_iterations; k++) {
+    p_matrix.CMultiply(x, y);
+    for (int i = 1; i <= n; i++) {
+      x[i] = y[i] / (1.0 + std::fabs(y[i]));
+    }
+    p_matrix += p_increment;
+    int row = k % n + 1;
+    if (p_matrix(row, row) != 0.0) {
+      p_matrix.Pivot(row, row);
+    }
+  }
+  p_result = x;
+}
+
+//
+// The path workload, as in the path tracer before its matrices had views
+//
+void GivensChecked(RowMatrix &b, RowMatrix &q,
+		   double &c1, double &c2, int l1, int l2, int l3)
+{
+  if (std::fabs(c1) + std::fabs(c2) == 0.0)  return;
+  double sn;
+  if (std::fabs(c2) >= std::fabs(c1)) {
+    sn = std::sqrt(1.0 + (c1/c2) * (c1/c2)) * std::fabs(c2);
+  }
+  else {
+    sn = std::sqrt(1.0 + (c2/c1) * (c2/c1)) * std::fabs(c1);
+  }
+  double s1 = c1/sn, s2 = c2/sn;
+  for (int k = 1; k <= q.NumColumns(); k++) {
+    double sv1 = q(l1, k), sv2 = q(l2, k);
+    q(l1, k) = s1 * sv1 + s2 * sv2;
+    q(l2, k) = -s2 * sv1 + s1 * sv2;
+  }
+  for (int k = l3; k <= b.NumColumns(); k++) {
+    double sv1 = b(l1, k), sv2 = b(l2, k);
+    b(l1, k) = s1 * sv1 + s2 * sv2;
+    b(l2, k) = -s2 * sv1 + s1 * sv2;
+  }
+  c1 = sn;
+  c2 = 0.0;
+}
+
+void NewtonChecked(RowMatrix &q, RowMatrix &b, Vector<double> &u,
+		   Vector<double> &y)
+{
+  for (int k = 1; k <= b.NumColumns(); k++) {
+    for (int l = 1; l <= k - 1; l++) {
+      y[k] -= b(l, k) * y[l];
+    }
+    y[k] /= b(k, k);
+  }
+  for (int k = 1; k <= b.NumRows(); k++) {
+    double s = 0.0;
+    for (int l = 1; l <= b.NumColumns(); l++) {
+      s += q(l, k) * y[l];
+    }
+    u[k] -= s;
+  }
+}
+
+void RunPath(const RowMatrix &p_jacobian, int p_iterations,
+	     Vector<double> &p_result)
+{
+  int n = p_jacobian.NumRows();
+  Vector<double> u(n), y(n - 1);
+  u = 0.0;
+  for (int k = 0; k < p_iterations; k++) {
+    RowMatrix b(p_jacobian), q(n, n);
+    q.MakeIdent();
+    for (int m = 1; m <= b.NumColumns(); m++) {
+      for (int l = m + 1; l <= b.NumRows(); l++) {
+	GivensChecked(b, q, b(m, m), b(l, m), m, l, m + 1);
+      }
+    }
+    for (int i = 1; i < n; i++) {
+      y[i] = 1.0 / (i + k);
+    }
+    NewtonChecked(q, b, u, y);
+  }
+  p_result = u;
+}
+
+//
+// The path workload, as in the path tracer now
+//
+void GivensViews(Matrix<double> &b, Matrix<double> &q,
+		 double &c1, double &c2, int l1, int l2, int l3)
+{
+  if (std::fabs(c1) + std::fabs(c2) == 0.0)  return;
+  double sn;
+  if (std::fabs(c2) >= std::fabs(c1)) {
+    sn = std::sqrt(1.0 + (c1/c2) * (c1/c2)) * std::fabs(c2);
+  }
+  else {
+    sn = std::sqrt(1.0 + (c2/c1) * (c2/c1)) * std::fabs(c1);
+  }
+  double s1 = c1/sn, s2 = c2/sn;
+  Matrix<double>::RowView q1 = q.ViewRow(l1), q2 = q.ViewRow(l2);
+  for (int k = 1; k <= q.NumColumns(); k++) {
+    double sv1 = q1[k], sv2 = q2[k];
+    q1[k] = s1 * sv1 + s2 * sv2;
+    q2[k] = -s2 * sv1 + s1 * sv2;
+  }
+  Matrix<double>::RowView b1 = b.ViewRow(l1), b2 = b.ViewRow(l2);
+  for (int k = l3; k <= b.NumColumns(); k++) {
+    double sv1 = b1[k], sv2 = b2[k];
+    b1[k] = s1 * sv1 + s2 * sv2;
+    b2[k] = -s2 * sv1 + s1 * sv2;
+  }
+  c1 = sn;
+  c2 = 0.0;
+}
+
+void NewtonViews(Matrix<double> &q, Matrix<double> &b, Vector<double> &u,
+		 Vector<double> &y, Vector<double> &s)
+{
+  for (int l = 1; l <= b.NumColumns(); l++) {
+    Matrix<double>::RowView row = b.ViewRow(l);
+    y[l] /= row[l];
+    for (int k = l + 1; k <= b.NumColumns(); k++) {
+      y[k] -= row[k] * y[l];
+    }
+  }
+  s = 0.0;
+  for (int l = 1; l <= b.NumColumns(); l++) {
+    Matrix<double>::RowView row = q.ViewRow(l);
+    for (int k = 1; k <= b.NumRows(); k++) {
+      s[k] += row[k] * y[l];
+    }
+  }
+  for (int k = 1; k <= b.NumRows(); k++) {
+    u[k] -= s[k];
+  }
+}
+
+void RunPath(const Matrix<double> &p_jacobian, int p_iterations,
+	     Vector<double> &p_result)
+{
+  int n = p_jacobian.NumRows();
+  Vector<double> u(n), y(n - 1), s(n);
+  u = 0.0;
+  for (int k = 0; k < p_iterations; k++) {
+    Matrix<double> b(p_jacobian), q(n, n);
+    q.MakeIdent();
+    for (int m = 1; m <= b.NumColumns(); m++) {
+      for (int l = m + 1; l <= b.NumRows(); l++) {
+	GivensViews(b, q, b(m, m), b(l, m), m, l, m + 1);
+      }
+    }
+    for (int i = 1; i < n; i++) {
+      y[i] = 1.0 / (i + k);
+    }
+    NewtonViews(q, b, u, y, s);
+  }
+  p_result = u;
+}
+
+template <class F> double TimeRuns(F p_run, int p_repeats)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 1; r <= p_repeats; r++) {
+    p_run();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count() / p_repeats;
+}
+
+void PrintHelp(char *progname)
+{
+  std::cerr << "Microbenchmark of dense matrix and path-following workloads\n";
+  std::cerr << "Usage: " << progname << " [OPTIONS]\n\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -n SIZE          number of rows in the matrices (default 100)\n";
+  std::cerr << "  -i ITERATIONS    number of iterations of each workload (default 50)\n";
+  std::cerr << "  -r REPEATS       number of times to repeat each run (default 5)\n";
+  std::cerr << "  -s SEED          seed for the random matrices (default 1)\n";
+  std::cerr << "  -h               print this help message\n";
+  exit(1);
+}
+
+void PrintTimes(const std::string &p_label, double p_rowTime,
+		double p_contiguousTime)
+{
+  std::cout << p_label << ":\n";
+  std::cout << "  contiguous:        " << p_contiguousTime << " ms\n";
+  std::cout << "  row pointers:      " << p_rowTime << " ms\n";
+  std::cout << "  speedup:           " << p_rowTime / p_contiguousTime << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+  int size = 100, iterations = 50, repeats = 5, seed = 1;
+  int c;
+  while ((c = getopt(argc, argv, "n:i:r:s:h")) != -1) {
+    switch (c) {
+    case 'n':  size = atoi(optarg);  break;
+    case 'i':  iterations = atoi(optarg);  break;
+    case 'r':  repeats = atoi(optarg);  break;
+    case 's':  seed = atoi(optarg);  break;
+    case 'h':  PrintHelp(argv[0]);  break;
+    default:   abort();
+    }
+  }
+  if (size < 2 || iterations < 1 || repeats < 1) {
+    PrintHelp(argv[0]);
+  }
+
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> entry(-1.0, 1.0);
+  Matrix<double> matrix(size, size), increment(size, size);
+  Matrix<double> jacobian(size, size - 1);
+  RowMatrix rowMatrix(size, size), rowIncrement(size, size);
+  RowMatrix rowJacobian(size, size - 1);
+  for (int i = 1; i <= size; i++) {
+    for (int j = 1; j <= size; j++) {
+      matrix(i, j) = rowMatrix(i, j) = entry(generator);
+      increment(i, j) = rowIncrement(i, j) = 1.0e-3 * entry(generator);
+      if (j < size) {
+	jacobian(i, j) = rowJacobian(i, j) = entry(generator);
+      }
+    }
+  }
+
+  Vector<double> contiguousResult(size), rowResult(size);
+  double contiguousTime = TimeRuns([&]() {
+      Matrix<double> m(matrix);
+      RunMatrix(m, increment, iterations, contiguousResult);
+    }, repeats);
+  double rowTime = TimeRuns([&]() {
+      RowMatrix m(rowMatrix);
+      RunMatrix(m, rowIncrement, iterations, rowResult);
+    }, repeats);
+  if (contiguousResult != rowResult) {
+    std::cerr << "Error: matrix workload results differ\n";
+    return 1;
+  }
+  std::cout << "matrices " << size << "x" << size << ", "
+	    << iterations << " iterations\n";
+  PrintTimes("matrix workload", rowTime, contiguousTime);
+
+  contiguousTime = TimeRuns([&]() {
+      RunPath(jacobian, iterations, contiguousResult);
+    }, repeats);
+  rowTime = TimeRuns([&]() {
+      RunPath(rowJacobian, iterations, rowResult);
+    }, repeats);
+  if (contiguousResult != rowResult) {
+    std::cerr << "Error: path workload results differ\n";
+    return 1;
+  }
+  PrintTimes("path workload", rowTime, contiguousTime);
+  return 0;
+}
@@ -0,0 +1,252 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2016, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/rationalbench.cc
+// Microbenchmark of exact arithmetic on tableau pivoting workloads
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+//
+// Runs the same sequence of simplex-style pivots on a dense tableau of
+// rationals twice: once using Gambit::Rational, which holds values which
+// fit in a machine word inline, and once using a rational built directly
+// on the arbitrary-precision IntegerRep routines, in the way Integer
+// always stored its values before it had the small-value form.  Both runs
+// must produce the same final tableau.
+//
+
+#include <cstdlib>
+#include <unistd.h>
+#include <getopt.h>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "gambit/gambit.h"
+
+using namespace Gambit;
+
+//
+// An integer always held in the arbitrary-precision representation
+//
+class RepInteger {
+private:
+  IntegerRep *rep;
+
+  explicit RepInteger(IntegerRep *r) : rep(r) { }
+
+public:
+  RepInteger(long y = 0) : rep(Icopy_long(0, y)) { }
+  RepInteger(const RepInteger &y) : rep(Icopy(0, y.rep)) { }
+  ~RepInteger() { if (!STATIC_IntegerRep(rep)) delete [] rep; }
+
+  RepInteger &operator=(const RepInteger &y)
+  { rep = Icopy(rep, y.rep); return *this; }
+
+  RepInteger operator+(const RepInteger &y) const
+  { return RepInteger(add(rep, 0, y.rep, 0, 0)); }
+  RepInteger operator-(const RepInteger &y) const
+  { return RepInteger(add(rep, 0, y.rep, 1, 0)); }
+  RepInteger operator*(const RepInteger &y) const
+  { return RepInteger(multiply(rep, y.rep, 0)); }
+  RepInteger operator/(const RepInteger &y) const
+  { return RepInteger(div(rep, y.rep, 0)); }
+  void negate(void) { rep = Gambit::negate(rep, rep); }
+
+  friend int sign(const RepInteger &x)
+  { return (x.rep->len == 0) ? 0 : ((x.rep->sgn == 1) ? 1 : -1); }
+  friend int compare(const RepInteger &x, const RepInteger &y)
+  { return Gambit::compare(x.rep, y.rep); }
+  friend RepInteger gcd(const RepInteger &x, const RepInteger &y)
+  { return RepInteger(Gambit::gcd(x.rep, y.rep)); }
+  friend std::string ToText(const RepInteger &x) { return Itoa(x.rep); }
+};
+
+//
+// A rational on RepInteger, normalized as Rational is
+//
+class RepRational {
+private:
+  RepInteger num, den;
+
+  void normalize(void)
+  {
+    if (sign(den) < 0) { num.negate(); den.negate(); }
+    RepInteger g = gcd(num, den);
+    if (compare(g, 1) != 0) { num = num / g; den = den / g; }
+  }
+
+public:
+  RepRational(long n = 0) : num(n), den(1) { }
+  RepRational(const RepInteger &n, const RepInteger &d) : num(n), den(d)
+  { normalize(); }
+
+  RepRational operator+(const RepRational &y) const
+  { return RepRational(num * y.den + den * y.num, den * y.den); }
+  RepRational operator-(const RepRational &y) const
+  { return RepRational(num * y.den - den * y.num, den * y.den); }
+  RepRational operator*(const RepRational &y) const
+  { return RepRational(num * y.num, den * y.den); }
+  RepRational operator/(const RepRational &y) const
+  { return RepRational(num * y.den, den * y.num); }
+  bool operator<(const RepRational &y) const
+  { return compare(num * y.den, den * y.num) < 0; }
+  bool operator>(const RepRational &y) const { return y < *this; }
+  bool operator!=(const RepRational &y) const
+  { return compare(num * y.den, den * y.num) != 0; }
+
+  friend std::string ToText(const RepRational &x)
+  { return ToText(x.num) + "/" + ToText(x.den); }
+};
+
+std::string ToText(const Rational &x)
+{ return lexical_cast<std::string>(x.numerator()) + "/" +
+    lexical_cast<std::string>(x.denominator()); }
+
+//
+// Runs p_pivots pivots on a p_rows by p_cols tableau, whose last column
+// is the (positive) right-hand side.  The entering column cycles through
+// the other columns, and the leaving row is chosen by the ratio test.
+// Returns the final tableau, written out as text.
+//
+template <class T> std::string
+RunPivots(const Array<Array<long> > &p_entries, int p_pivots)
+{
+  int rows = p_entries.Length(), cols = p_entries[1].Length();
+  Array<Array<T> > tab(rows);
+  for (int i = 1; i <= rows; i++) {
+    tab[i] = Array<T>(cols);
+    for (int j = 1; j <= cols; j++) {
+      tab[i][j] = T(p_entries[i][j]);
+    }
+  }
+
+  for (int k = 0; k < p_pivots; k++) {
+    int col = k % (cols - 1) + 1, row = 0;
+    T best;
+    for (int i = 1; i <= rows; i++) {
+      if (tab[i][col] > T(0)) {
+	T ratio = tab[i][cols] / tab[i][col];
+	if (row == 0 || ratio < best) {
+	  row = i;
+	  best = ratio;
+	}
+      }
+    }
+    if (row == 0) {
+      continue;
+    }
+    T pivot = tab[row][col];
+    for (int j = 1; j <= cols; j++) {
+      tab[row][j] = tab[row][j] / pivot;
+    }
+    for (int i = 1; i <= rows; i++) {
+      if (i != row && tab[i][col] != T(0)) {
+	T factor = tab[i][col];
+	for (int j = 1; j <= cols; j++) {
+	  tab[i][j] = tab[i][j] - factor * tab[row][j];
+	}
+      }
+    }
+  }
+
+  std::string text;
+  for (int i = 1; i <= rows; i++) {
+    for (int j = 1; j <= cols; j++) {
+      text += ToText(tab[i][j]) + " ";
+    }
+  }
+  return text;
+}
+
+template <class T> double
+TimePivots(const Array<Array<long> > &p_entries, int p_pivots, int p_repeats,
+	   std::string &p_result)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 1; r <= p_repeats; r++) {
+    p_result = RunPivots<T>(p_entries, p_pivots);
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count() / p_repeats;
+}
+
+void PrintHelp(char *progname)
+{
+  std::cerr << "Microbenchmark of exact arithmetic on tableau pivoting\n";
+  std::cerr << "Usage: " << progname << " [OPTIONS]\n\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -m ROWS          number of rows in the tableau (default 8)\n";
+  std::cerr << "  -n COLS          number of columns in the tableau (default 16)\n";
+  std::cerr << "  -p PIVOTS        number of pivots to do (default 200)\n";
+  std::cerr << "  -r REPEATS       number of times to repeat each run (default 5)\n";
+  std::cerr << "  -b BITS          size of the initial entries in bits (default 3)\n";
+  std::cerr << "  -s SEED          seed for the random tableau (default 1)\n";
+  std::cerr << "  -h               print this help message\n";
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  int rows = 8, cols = 16, pivots = 200, repeats = 5, bits = 3, seed = 1;
+  int c;
+  while ((c = getopt(argc, argv, "m:n:p:r:b:s:h")) != -1) {
+    switch (c) {
+    case 'm':  rows = atoi(optarg);  break;
+    case 'n':  cols = atoi(optarg);  break;
+    case 'p':  pivots = atoi(optarg);  break;
+    case 'r':  repeats = atoi(optarg);  break;
+    case 'b':  bits = atoi(optarg);  break;
+    case 's':  seed = atoi(optarg);  break;
+    case 'h':  PrintHelp(argv[0]);  break;
+    default:   abort();
+    }
+  }
+  if (rows < 1 || cols < 2 || pivots < 0 || repeats < 1 ||
+      bits < 1 || bits > 30) {
+    PrintHelp(argv[0]);
+  }
+
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<long> entry(-(1L << bits), 1L << bits);
+  std::uniform_int_distribution<long> rhs(1, 1L << bits);
+  Array<Array<long> > entries(rows);
+  for (int i = 1; i <= rows; i++) {
+    entries[i] = Array<long>(cols);
+    for (int j = 1; j < cols; j++) {
+      entries[i][j] = entry(generator);
+    }
+    entries[i][cols] = rhs(generator);
+  }
+
+  std::string small, big;
+  double smallTime = TimePivots<Rational>(entries, pivots, repeats, small);
+  double bigTime = TimePivots<RepRational>(entries, pivots, repeats, big);
+  if (small != big) {
+    std::cerr << "Error: final tableaus differ\n";
+    return 1;
+  }
+
+  std::cout << "tableau " << rows << "x" << cols << ", " << pivots
+	    << " pivots, " << bits << "-bit entries\n";
+  std::cout << "Rational:            " << smallTime << " ms\n";
+  std::cout << "arbitrary precision: " << bigTime << " ms\n";
+  std::cout << "speedup:             " << bigTime / smallTime << "\n";
+  return 0;
+}
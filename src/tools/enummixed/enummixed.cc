@@ -29,6 +29,7 @@
 #include <iomanip>
 
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "gambit/nash/enummixed.h"
 
 using namespace Gambit;
@@ -144,6 +145,10 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree()) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     if (uselrs) {
       shared_ptr<StrategyProfileRenderer<Rational> > renderer;
       renderer = new MixedStrategyCSVRenderer<Rational>(std::cout);
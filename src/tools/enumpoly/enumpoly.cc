@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "nfghs.h"
 
 int g_numDecimals = 6;
@@ -132,6 +133,10 @@ int main(int argc, char *argv[])
 
   try {
     Gambit::Game game = Gambit::ReadGame(*input_stream);
+    if (game->IsTree() && useStrategic) {
+      dynamic_cast<Gambit::GameTreeRep &>(*game).SetPayoffTableLimit(
+	Gambit::GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     if (!game->IsPerfectRecall()) {
       throw Gambit::UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
     }
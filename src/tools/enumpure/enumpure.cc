@@ -28,6 +28,7 @@
 #include <cerrno>
 
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "gambit/nash.h"
 
 using namespace Gambit;
@@ -125,6 +126,10 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree() && !solveAgent) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     shared_ptr<StrategyProfileRenderer<Rational> > renderer;
     if (reportStrategic || !game->IsTree()) {
       if (printDetail) {
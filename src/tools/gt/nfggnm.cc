@@ -27,7 +27,9 @@
 #include <fstream>
 #include <cerrno>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "gambit/nash/gnm.h"
+#include "gambit/nash/multistart.h"
 
 using namespace Gambit;
 using namespace Gambit::Nash;
@@ -68,6 +70,34 @@ RandomStrategyPerturbations(const Game &p_game, int p_count)
   return profiles;
 }
 
+class GNMStarts
+  : public MultiStartSolver<MixedStrategyProfile<double>,
+			    MixedStrategyProfile<double> > {
+public:
+  GNMStarts(const Game &p_game, int p_numDecimals, bool p_verbose,
+	    int p_numThreads, int p_stopAfter)
+    : MultiStartSolver<MixedStrategyProfile<double>,
+		       MixedStrategyProfile<double> >(p_numThreads, p_stopAfter),
+      m_game(p_game), m_numDecimals(p_numDecimals), m_verbose(p_verbose)
+  { }
+  virtual ~GNMStarts() { }
+
+  virtual List<MixedStrategyProfile<double> > 
+  SolveStart(const MixedStrategyProfile<double> &p_pert,
+	     std::ostream &p_stream) const
+  {
+    shared_ptr<StrategyProfileRenderer<double> > renderer;
+    renderer = new MixedStrategyCSVRenderer<double>(p_stream, m_numDecimals);
+    NashGNMStrategySolver solver(renderer, m_verbose);
+    return solver.Solve(m_game, p_pert);
+  }
+
+private:
+  Game m_game;
+  int m_numDecimals;
+  bool m_verbose;
+};
+
 void PrintBanner(std::ostream &p_stream)
 {
   p_stream << "Compute Nash equilibria using a global Newton method\n";
@@ -87,6 +117,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -n COUNT         number of perturbation vectors to generate\n";
   std::cerr << "  -s FILE          file containing perturbation vectors\n";
+  std::cerr << "  -j THREADS       solve from THREADS perturbation vectors at once\n";
+  std::cerr << "  -e EQA           terminate after finding EQA distinct equilibria\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -99,6 +131,7 @@ int main(int argc, char *argv[])
   opterr = 0;
   bool quiet = false, verbose = false;
   int numDecimals = 6, numVectors = 1;
+  int numThreads = 1, stopAfter = 0;
   std::string startFile;
 
   int long_opt_index = 0;
@@ -109,7 +142,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:qvVhS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:n:s:j:e:qvVhS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -128,6 +161,12 @@ int main(int argc, char *argv[])
     case 's':
       startFile = optarg;
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
+    case 'e':
+      stopAfter = atoi(optarg);
+      break;
     case 'S':
       break;
     case 'h':
@@ -165,10 +204,14 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
-    shared_ptr<StrategyProfileRenderer<double> > renderer;
-    renderer = new MixedStrategyCSVRenderer<double>(std::cout,
-						    numDecimals);
-    NashGNMStrategySolver solver(renderer, verbose);
+    if (game->IsTree()) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
+    if (game->IsAgg() || game->IsBagg()) {
+      // Evaluating profiles on action graph games is not thread-safe
+      numThreads = 1;
+    }
 
     List<MixedStrategyProfile<double> > perts;
     if (startFile != "") {
@@ -179,9 +222,8 @@ int main(int argc, char *argv[])
       // Generate the desired number of points randomly
       perts = RandomStrategyPerturbations(game, numVectors);
     }
-    for (int i = 1; i <= perts.size(); i++) {
-      solver.Solve(game, perts[i]);
-    }
+    GNMStarts solver(game, numDecimals, verbose, numThreads, stopAfter);
+    solver.Solve(perts, std::cout);
     return 0;
   }
   catch (std::runtime_error &e) {
@@ -26,6 +26,7 @@
 #include <fstream>
 #include <cerrno>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "gambit/nash/ipa.h"
 
 using namespace Gambit;
@@ -121,6 +122,10 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree()) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     shared_ptr<StrategyProfileRenderer<double> > renderer;
     renderer = new MixedStrategyCSVRenderer<double>(std::cout,
 						    numDecimals);
@@ -27,6 +27,8 @@
 #include <unistd.h>
 #include <getopt.h>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
+#include "gambit/nash/multistart.h"
 #include "efgliap.h"
 #include "nfgliap.h"
 
@@ -51,6 +53,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -n COUNT         number of starting points to generate\n";
   std::cerr << "  -s FILE          file containing starting points\n";
+  std::cerr << "  -j THREADS       solve from THREADS starting points at once\n";
+  std::cerr << "  -e EQA           terminate after finding EQA distinct equilibria\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "                   (default is to only show equilibria)\n";
@@ -130,6 +134,62 @@ RandomBehaviorProfiles(const Game &p_game, int p_count)
   return profiles;
 }
 
+class LiapStrategyStarts
+  : public MultiStartSolver<MixedStrategyProfile<double>,
+			    MixedStrategyProfile<double> > {
+public:
+  LiapStrategyStarts(int p_maxitsN, bool p_verbose, int p_numDecimals,
+		     int p_numThreads, int p_stopAfter)
+    : MultiStartSolver<MixedStrategyProfile<double>,
+		       MixedStrategyProfile<double> >(p_numThreads, p_stopAfter),
+      m_maxitsN(p_maxitsN), m_verbose(p_verbose), m_numDecimals(p_numDecimals)
+  { }
+  virtual ~LiapStrategyStarts() { }
+
+  virtual List<MixedStrategyProfile<double> > 
+  SolveStart(const MixedStrategyProfile<double> &p_start,
+	     std::ostream &p_stream) const
+  {
+    shared_ptr<StrategyProfileRenderer<double> > renderer;
+    renderer = new MixedStrategyCSVRenderer<double>(p_stream, m_numDecimals);
+    NashLiapStrategySolver algorithm(m_maxitsN, m_verbose, renderer);
+    return algorithm.Solve(p_start);
+  }
+
+private:
+  int m_maxitsN;
+  bool m_verbose;
+  int m_numDecimals;
+};
+
+class LiapBehavStarts
+  : public MultiStartSolver<MixedBehaviorProfile<double>,
+			    MixedBehaviorProfile<double> > {
+public:
+  LiapBehavStarts(int p_maxitsN, bool p_verbose, int p_numDecimals,
+		  int p_numThreads, int p_stopAfter)
+    : MultiStartSolver<MixedBehaviorProfile<double>,
+		       MixedBehaviorProfile<double> >(p_numThreads, p_stopAfter),
+      m_maxitsN(p_maxitsN), m_verbose(p_verbose), m_numDecimals(p_numDecimals)
+  { }
+  virtual ~LiapBehavStarts() { }
+
+  virtual List<MixedBehaviorProfile<double> > 
+  SolveStart(const MixedBehaviorProfile<double> &p_start,
+	     std::ostream &p_stream) const
+  {
+    shared_ptr<StrategyProfileRenderer<double> > renderer;
+    renderer = new BehavStrategyCSVRenderer<double>(p_stream, m_numDecimals);
+    NashLiapBehavSolver algorithm(m_maxitsN, m_verbose, renderer);
+    return algorithm.Solve(p_start);
+  }
+
+private:
+  int m_maxitsN;
+  bool m_verbose;
+  int m_numDecimals;
+};
+
 int main(int argc, char *argv[])
 {
   opterr = 0;
@@ -137,6 +197,7 @@ int main(int argc, char *argv[])
   int numTries = 10;
   int maxitsN = 100;
   int numDecimals = 6;
+  int numThreads = 1, stopAfter = 0;
   double tolN = 1.0e-10;
   std::string startFile = "";
  
@@ -148,7 +209,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:hqVvS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:n:s:j:e:hqVvS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -161,6 +222,12 @@ int main(int argc, char *argv[])
     case 's':
       startFile = optarg;
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
+    case 'e':
+      stopAfter = atoi(optarg);
+      break;
     case 'h':
       PrintHelp(argv[0]);
       break;
@@ -205,6 +272,14 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree() && useStrategic) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
+    if (game->IsAgg() || game->IsBagg()) {
+      // Evaluating profiles on action graph games is not thread-safe
+      numThreads = 1;
+    }
     if (!game->IsTree() || useStrategic) {
       List<MixedStrategyProfile<double> > starts;
       if (startFile != "") {
@@ -216,13 +291,9 @@ int main(int argc, char *argv[])
 	starts = RandomStrategyProfiles(game, numTries);
       }
 
-      for (int i = 1; i <= starts.size(); i++) {
-	shared_ptr<StrategyProfileRenderer<double> > renderer;
-	renderer = new MixedStrategyCSVRenderer<double>(std::cout,
-							numDecimals);
-	NashLiapStrategySolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
-      }
+      LiapStrategyStarts algorithm(maxitsN, verbose, numDecimals,
+				   numThreads, stopAfter);
+      algorithm.Solve(starts, std::cout);
     }
     else {
       List<MixedBehaviorProfile<double> > starts;
@@ -235,13 +306,9 @@ int main(int argc, char *argv[])
 	starts = RandomBehaviorProfiles(game, numTries);
       }
 
-      for (int i = 1; i <= starts.size(); i++) {
-	shared_ptr<StrategyProfileRenderer<double> > renderer;
-	renderer = new BehavStrategyCSVRenderer<double>(std::cout,
-							numDecimals);
-	NashLiapBehavSolver algorithm(maxitsN, verbose, renderer);
-	algorithm.Solve(starts[i]);
-      }
+      LiapBehavStarts algorithm(maxitsN, verbose, numDecimals,
+				numThreads, stopAfter);
+      algorithm.Solve(starts, std::cout);
     }
     return 0;
   }
@@ -49,12 +49,21 @@ private:
   double Value(const Vector<double> &) const;
   bool Gradient(const Vector<double> &, Vector<double> &) const;
 
-  double LiapDerivValue(int, int, const MixedStrategyProfile<double> &) const;
+  double LiapDerivValue(int, int, const MixedStrategyProfile<double> &,
+			const PVector<double> &, const Vector<double> &) const;
 };
 
+//
+// Computes the derivative of the Lyapunov function with respect to the
+// j1'th strategy of player i1.  The values of each strategy and the
+// payoffs to each player at the profile are passed in, as these are
+// common to all the partial derivatives.
+//
 double 
 StrategicLyapunovFunction::LiapDerivValue(int i1, int j1,
-					  const MixedStrategyProfile<double> &p) const
+					  const MixedStrategyProfile<double> &p,
+					  const PVector<double> &p_values,
+					  const Vector<double> &p_payoffs) const
 {
   GameStrategy wrt_strategy = m_game->Players()[i1]->Strategies()[j1];
   double x = 0.0;
@@ -64,10 +73,10 @@ StrategicLyapunovFunction::LiapDerivValue(int i1, int j1,
     for (int j = 1; j <= player->NumStrategies(); j++)  {
       GameStrategy strategy = player->Strategies()[j];
       psum += p[strategy];
-      double x1 = p.GetPayoff(strategy) - p.GetPayoff(i);
+      double x1 = p_values(i, j) - p_payoffs[i];
       if (i1 == i) {
 	if (x1 > 0.0)
-	  x -= x1 * p.GetPayoffDeriv(i, wrt_strategy);
+	  x -= x1 * p_values(i1, j1);
       }
       else if (x1 > 0.0) {
 	x += x1 * (p.GetPayoffDeriv(i, strategy, wrt_strategy) - 
@@ -88,9 +97,15 @@ bool
 StrategicLyapunovFunction::Gradient(const Vector<double> &v, Vector<double> &d) const
 {
   static_cast<Vector<double> &>(m_profile).operator=(v);
+  PVector<double> values(m_game->NumStrategies());
+  m_profile.GetStrategyValues(values);
+  Vector<double> payoffs(m_game->NumPlayers());
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    payoffs[pl] = m_profile.GetPayoff(pl);
+  }
   for (int pl = 1, ii = 1; pl <= m_game->NumPlayers(); pl++) {
     for (int st = 1; st <= m_game->Players()[pl]->Strategies().size(); st++) {
-      d[ii++] = LiapDerivValue(pl, st, m_profile);
+      d[ii++] = LiapDerivValue(pl, st, m_profile, values, payoffs);
     }
   }
   Project(d, m_game->NumStrategies());
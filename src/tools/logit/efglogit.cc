@@ -53,9 +53,14 @@ private:
     virtual ~Equation() { }
     virtual double Value(const LogBehavProfile<double> &p_point,
 			 double p_lambda) const = 0;
-    virtual void Gradient(const LogBehavProfile<double> &p_point, 
-			  double p_lambda,
-			  Vector<double> &p_gradient) const = 0;
+    // Derivative with respect to the log-probability of p_action, given
+    // the derivatives p_diffs of all action values with respect to it
+    virtual double Derivative(const LogBehavProfile<double> &p_point,
+			      double p_lambda, const GameAction &p_action,
+			      const DVector<double> &p_diffs) const = 0;
+    // Derivative with respect to lambda
+    virtual double LambdaDerivative(const LogBehavProfile<double> &p_point,
+				    double p_lambda) const = 0;
   };
 
   //
@@ -76,8 +81,11 @@ private:
 
     double Value(const LogBehavProfile<double> &p_profile,
 		 double p_lambda) const;
-    void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
-		  Vector<double> &p_gradient) const;
+    double Derivative(const LogBehavProfile<double> &p_profile,
+		      double p_lambda, const GameAction &p_action,
+		      const DVector<double> &p_diffs) const;
+    double LambdaDerivative(const LogBehavProfile<double> &p_profile,
+			    double p_lambda) const;
   };
 
   //
@@ -99,8 +107,11 @@ private:
 
     double Value(const LogBehavProfile<double> &p_profile, 
 		 double p_lambda) const;
-    void Gradient(const LogBehavProfile<double> &p_profile, double p_lambda,
-		  Vector<double> &p_gradient) const;
+    double Derivative(const LogBehavProfile<double> &p_profile,
+		      double p_lambda, const GameAction &p_action,
+		      const DVector<double> &p_diffs) const;
+    double LambdaDerivative(const LogBehavProfile<double> &p_profile,
+			    double p_lambda) const;
   };
 
   Array<Equation *> m_equations;
@@ -139,34 +150,26 @@ AgentQREPathTracer::EquationSystem::SumToOneEquation::Value(const LogBehavProfil
   return value;
 }
 
-void
-AgentQREPathTracer::EquationSystem::SumToOneEquation::Gradient(const LogBehavProfile<double> &p_profile,
-							       double p_lambda,
-							       Vector<double> &p_gradient) const
+double
+AgentQREPathTracer::EquationSystem::SumToOneEquation::Derivative(const LogBehavProfile<double> &p_profile,
+								 double p_lambda,
+								 const GameAction &p_action,
+								 const DVector<double> &p_diffs) const
 {
-  int i = 1;
-  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
-    GamePlayer player = m_game->GetPlayer(pl);
-
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameInfoset infoset = player->GetInfoset(iset);
-
-      for (int act = 1; act <= infoset->NumActions(); act++, i++) {
-	if (pl == m_pl && iset == m_iset) {
-	  p_gradient[i] = p_profile.GetProb(pl, iset, act);
-	}
-	else {
-	  p_gradient[i] = 0.0;
-	}
-      }
-    }
+  if (p_action->GetInfoset() == m_infoset) {
+    return p_profile.GetProb(m_pl, m_iset, p_action->GetNumber());
+  }
+  else {
+    return 0.0;
   }
-
-  // Derivative wrt lambda is zero
-  p_gradient[i] = 0.0;
 }
-			       
 
+double
+AgentQREPathTracer::EquationSystem::SumToOneEquation::LambdaDerivative(const LogBehavProfile<double> &p_profile,
+								       double p_lambda) const
+{
+  return 0.0;
+}
 
 double
 AgentQREPathTracer::EquationSystem::RatioEquation::Value(const LogBehavProfile<double> &p_profile,
@@ -179,42 +182,34 @@ AgentQREPathTracer::EquationSystem::RatioEquation::Value(const LogBehavProfile<d
 	   p_profile.GetPayoff(m_infoset->GetAction(1))));
 }
 
-void
-AgentQREPathTracer::EquationSystem::RatioEquation::Gradient(const LogBehavProfile<double> &p_profile,
-							    double p_lambda,
-							    Vector<double> &p_gradient) const
+double
+AgentQREPathTracer::EquationSystem::RatioEquation::Derivative(const LogBehavProfile<double> &p_profile,
+							      double p_lambda,
+							      const GameAction &p_action,
+							      const DVector<double> &p_diffs) const
 {
-  int i = 1;
-  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
-    GamePlayer player = m_game->GetPlayer(pl);
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameInfoset infoset = player->GetInfoset(iset);
-      for (int act = 1; act <= infoset->NumActions(); act++, i++) {
-	if (infoset == m_infoset) {
-	  if (act == 1) {
-	    p_gradient[i] = -1.0;
-	  }
-	  else if (act == m_act) {
-	    p_gradient[i] = 1.0; 
-	  }
-	  else {
-	    p_gradient[i] = 0.0;
-	  }
-	}
-	else {   // infoset1 != infoset2
-	  p_gradient[i] = 
-	    -p_lambda * 
-	    (p_profile.DiffActionValue(m_infoset->GetAction(m_act),
-				       infoset->GetAction(act)) -
-	     p_profile.DiffActionValue(m_infoset->GetAction(1),
-				       infoset->GetAction(act)));
-	}
-      }
+  if (p_action->GetInfoset() == m_infoset) {
+    if (p_action->GetNumber() == 1) {
+      return -1.0;
+    }
+    else if (p_action->GetNumber() == m_act) {
+      return 1.0;
     }
+    else {
+      return 0.0;
+    }
+  }
+  else {
+    return -p_lambda * (p_diffs(m_pl, m_iset, m_act) - p_diffs(m_pl, m_iset, 1));
   }
+}
 
-  p_gradient[i] = (p_profile.GetPayoff(m_infoset->GetAction(1)) -
-		   p_profile.GetPayoff(m_infoset->GetAction(m_act)));
+double
+AgentQREPathTracer::EquationSystem::RatioEquation::LambdaDerivative(const LogBehavProfile<double> &p_profile,
+								    double p_lambda) const
+{
+  return (p_profile.GetPayoff(m_infoset->GetAction(1)) -
+	  p_profile.GetPayoff(m_infoset->GetAction(m_act)));
 }
 
 
@@ -244,10 +239,29 @@ AgentQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_point,
   }
   double lambda = p_point[p_point.Length()];
 
+  // Each row holds the derivatives with respect to one variable.  The
+  // derivatives of all action values with respect to an action are
+  // computed together in one traversal of the tree, so the Jacobian
+  // costs one traversal per action.
+  DVector<double> diffs(m_game->NumActions());
+  int row = 1;
+  for (int pl = 1; pl <= m_game->NumPlayers(); pl++) {
+    GamePlayer player = m_game->GetPlayer(pl);
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      for (int act = 1; act <= infoset->NumActions(); act++, row++) {
+	GameAction action = infoset->GetAction(act);
+	profile.DiffActionValues(action, diffs);
+	for (int i = 1; i <= m_equations.Length(); i++) {
+	  p_matrix(row, i) = m_equations[i]->Derivative(profile, lambda,
+							 action, diffs);
+	}
+      }
+    }
+  }
+
   for (int i = 1; i <= m_equations.Length(); i++) {
-    Vector<double> column(p_point.Length());
-    m_equations[i]->Gradient(profile, lambda, column);
-    p_matrix.SetColumn(i, column);
+    p_matrix(row, i) = m_equations[i]->LambdaDerivative(profile, lambda);
   }
 }
 
@@ -68,6 +68,10 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_gripe;
 
+  // structures for storing derivatives with respect to one action
+  mutable Matrix<T> m_diffNodeValues;
+  mutable Array<bool> m_isPrecededBy;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -84,6 +88,9 @@ protected:
   void ComputeSolutionDataPass2(const GameNode &node) const;
   void ComputeSolutionDataPass1(const GameNode &node) const;
   void ComputeSolutionData(void) const;
+
+  void ComputeDiffNodeValues(const GameNode &node, 
+			     const GameAction &oppAction, bool isPrec) const;
   //@}
 
 public:
@@ -195,6 +202,13 @@ public:
 		   const GameAction &oppAction) const;
   T DiffNodeValue(const GameNode &node, const GamePlayer &player,
 		  const GameAction &oppAction) const;
+  /// Computes the derivatives of the values of all actions with respect
+  /// to the log-probability of oppAction, in a single traversal of the
+  /// tree.  This gives the same values as calling DiffActionValue()
+  /// for each action, at the cost of one call to DiffNodeValue() at the
+  /// root.  Entries for actions at oppAction's information set are zero.
+  void DiffActionValues(const GameAction &oppAction, 
+			DVector<T> &values) const;
 
   //@}
 };
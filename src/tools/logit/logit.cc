@@ -28,6 +28,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "efglogit.h"
 #include "nfglogit.h"
 
@@ -173,6 +174,10 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree() && useStrategic) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     if (!game->IsPerfectRecall()) {
       throw UndefinedException("Computing equilibria of games with imperfect recall is not supported.");
     }
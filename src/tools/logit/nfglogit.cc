@@ -46,7 +46,7 @@ public:
 			   Matrix<double> &p_matrix) const;
 
 private:
-  const Game &m_game;
+  Game m_game;
 };
 
 void 
@@ -59,6 +59,8 @@ StrategicQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
     logprofile[i] = p_point[i];
   }
   double lambda = p_point[p_point.Length()];
+  PVector<double> values(m_game->NumStrategies());
+  profile.GetStrategyValues(values);
   p_lhs = 0.0;
   for (int rowno = 0, pl = 1; pl <= m_game->NumPlayers(); pl++) {
     GamePlayer player = m_game->Players()[pl];
@@ -75,8 +77,7 @@ StrategicQREPathTracer::EquationSystem::GetValue(const Vector<double> &p_point,
 	// This is a ratio equation
 	p_lhs[rowno] = (logprofile[player->GetStrategy(st)] - 
 			logprofile[player->GetStrategy(1)] -
-			lambda * (profile.GetPayoff(player->GetStrategy(st)) -
-				  profile.GetPayoff(player->GetStrategy(1))));
+			lambda * (values(pl, st) - values(pl, 1)));
 
       }
     }
@@ -93,6 +94,11 @@ StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_poin
     logprofile[i] = p_point[i];
   }
   double lambda = p_point[p_point.Length()];
+  PVector<double> values(m_game->NumStrategies());
+  profile.GetStrategyValues(values);
+  Matrix<double> pairValues(profile.MixedProfileLength(),
+			    profile.MixedProfileLength());
+  profile.GetStrategyPairValues(pairValues);
 
   p_matrix = 0.0;
 
@@ -130,21 +136,15 @@ StrategicQREPathTracer::EquationSystem::GetJacobian(const Vector<double> &p_poin
 	      // Entry is zero for all other strategy pairs
 	    }
 	    else {
+	      // Row (rowno - j + 1) of pairValues is strategy 1 of player i
 	      p_matrix(colno, rowno) =
 		-lambda * profile[player2->GetStrategy(m)] *
-		(profile.GetPayoffDeriv(i, 
-					player->GetStrategy(j),
-					player2->GetStrategy(m)) -
-		 profile.GetPayoffDeriv(i, 
-					player->GetStrategy(1),
-					player2->GetStrategy(m)));
+		(pairValues(rowno, colno) - pairValues(rowno - j + 1, colno));
 	    }
 	  }
 	}
 	// Fill the last column, the derivative wrt lambda
-	p_matrix(p_matrix.NumRows(), rowno) =
-	  (profile.GetPayoff(player->GetStrategy(1)) - 
-	   profile.GetPayoff(player->GetStrategy(j)));
+	p_matrix(p_matrix.NumRows(), rowno) = values(i, 1) - values(i, j);
       }
     }
   }
@@ -186,7 +186,7 @@ public:
   
 private:
   std::ostream &m_stream;
-  const Game &m_game;
+  Game m_game;
   bool m_fullGraph;
   double m_decimals;
   mutable List<LogitQREMixedStrategyProfile> m_profiles;
@@ -315,7 +315,7 @@ private:
   void PrintProfile(const MixedStrategyProfile<double> &, double) const;
 
   std::ostream &m_stream;
-  const Game &m_game;
+  Game m_game;
   const Vector<double> &m_frequencies;
   bool m_fullGraph;
   double m_decimals;
@@ -22,10 +22,10 @@
 
 #include <cmath>
 #include <algorithm>   // for std::max
+#include <limits>
 #include <iostream>
 
 #include <gambit/gambit.h>
-#include <gambit/sqmatrix.h>
 #include "path.h"
 
 namespace Gambit {
@@ -55,59 +55,445 @@ void Givens(Matrix<double> &b, Matrix<double> &q,
   double s1 = c1/sn;
   double s2 = c2/sn;
 
+  Matrix<double>::RowView q1 = q.ViewRow(l1), q2 = q.ViewRow(l2);
   for (int k = 1; k <= q.NumColumns(); k++) {
-    double sv1 = q(l1, k);
-    double sv2 = q(l2, k);
-    q(l1, k) = s1 * sv1 + s2 * sv2;
-    q(l2, k) = -s2 * sv1 + s1 * sv2;
+    double sv1 = q1[k];
+    double sv2 = q2[k];
+    q1[k] = s1 * sv1 + s2 * sv2;
+    q2[k] = -s2 * sv1 + s1 * sv2;
   }
 
+  Matrix<double>::RowView b1 = b.ViewRow(l1), b2 = b.ViewRow(l2);
   for (int k = l3; k <= b.NumColumns(); k++) {
-    double sv1 = b(l1, k);
-    double sv2 = b(l2, k);
-    b(l1, k) = s1 * sv1 + s2 * sv2;
-    b(l2, k) = -s2 * sv1 + s1 * sv2;
+    double sv1 = b1[k];
+    double sv2 = b2[k];
+    b1[k] = s1 * sv1 + s2 * sv2;
+    b2[k] = -s2 * sv1 + s1 * sv2;
   }
 
   c1 = sn;
   c2 = 0.0;
 }
 
-void QRDecomp(Matrix<double> &b, Matrix<double> &q)
+//
+// Rotates rows p_row and p_row+1 of p_matrix in columns p_firstCol and on
+//
+void RotateRows(Matrix<double> &p_matrix, int p_row, double p_c, double p_s,
+		int p_firstCol)
+{
+  Matrix<double>::RowView r1 = p_matrix.ViewRow(p_row);
+  Matrix<double>::RowView r2 = p_matrix.ViewRow(p_row + 1);
+  for (int k = p_firstCol; k <= p_matrix.NumColumns(); k++) {
+    double sv1 = r1[k], sv2 = r2[k];
+    r1[k] = p_c * sv1 + p_s * sv2;
+    r2[k] = -p_s * sv1 + p_c * sv2;
+  }
+}
+
+//
+// Updates the triangular factor R of Q B = [R; 0] to that of B + u v^T,
+// given w = Q u, by the method of Allgower and Georg (Section 16.3).
+// Each rotation applied to R is passed to p_rotateQ to be applied to Q.
+//
+template <class F>
+void UpdateTriangular(Matrix<double> &p_r, Array<double> &p_w,
+		      const Array<double> &p_v, F p_rotateQ)
+{
+  int m = p_r.NumRows(), n = p_r.NumColumns();
+  // Reduce w to a multiple of the first unit vector, leaving R upper
+  // Hessenberg
+  for (int k = m - 1; k >= 1; k--) {
+    if (p_w[k + 1] == 0.0)  continue;
+    double r = std::sqrt(sqr(p_w[k]) + sqr(p_w[k + 1]));
+    double c = p_w[k] / r, s = p_w[k + 1] / r;
+    p_w[k] = r;
+    p_w[k + 1] = 0.0;
+    RotateRows(p_r, k, c, s, std::min(k, n));
+    p_rotateQ(k, c, s);
+  }
+
+  Matrix<double>::RowView first = p_r.ViewRow(1);
+  for (int k = 1; k <= n; k++) {
+    first[k] += p_w[1] * p_v[k];
+  }
+
+  // Restore R to upper triangular form
+  for (int k = 1; k <= n; k++) {
+    double c1 = p_r(k, k), c2 = p_r(k + 1, k);
+    if (c2 == 0.0)  continue;
+    double r = std::sqrt(sqr(c1) + sqr(c2));
+    double c = c1 / r, s = c2 / r;
+    RotateRows(p_r, k, c, s, k);
+    p_r(k + 1, k) = 0.0;
+    p_rotateQ(k, c, s);
+  }
+}
+
+//
+// Solves R^T z = y for z, overwriting y, where R is the upper triangle
+// of p_r
+//
+void SolveTransposed(const Matrix<double> &p_r, Array<double> &y, int n)
 {
-  q.MakeIdent();
-  for (int m = 1; m <= b.NumColumns(); m++) {
-    for (int k = m + 1; k <= b.NumRows(); k++) {
-      Givens(b, q, b(m, m), b(k, m), m, k, m + 1);
+  // Runs along the rows of R; each entry of y still accumulates its
+  // terms in increasing order of row.
+  for (int l = 1; l <= n; l++) {
+    Matrix<double>::ConstRowView row = p_r.ViewRow(l);
+    y[l] /= row[l];
+    for (int k = l + 1; k <= n; k++) {
+      y[k] -= row[k] * y[l];
     }
   }
 }
 
-void NewtonStep(Matrix<double> &q, Matrix<double> &b,
-                Vector<double> &u, Vector<double> &y,
-		double &d)
+}   // end anonymous namespace
+
+//----------------------------------------------------------------------------
+//                 PathTracer: Decomposition by Givens rotations
+//----------------------------------------------------------------------------
+
+void PathTracer::GivensDecomposition::Factor(const Matrix<double> &p_matrix)
 {
-  for (int k = 1; k <= b.NumColumns(); k++) {
-    for (int l = 1; l <= k - 1; l++) {
-      y[k] -= b(l, k) * y[l];
+  m_r = p_matrix;
+  if (m_q.NumRows() != p_matrix.NumRows()) {
+    m_q = Matrix<double>(p_matrix.NumRows(), p_matrix.NumRows());
+    m_work = Array<double>(p_matrix.NumRows());
+  }
+  m_q.MakeIdent();
+  for (int m = 1; m <= m_r.NumColumns(); m++) {
+    for (int k = m + 1; k <= m_r.NumRows(); k++) {
+      Givens(m_r, m_q, m_r(m, m), m_r(k, m), m, k, m + 1);
     }
-    y[k] /= b(k, k);
   }
+}
 
-  d = 0.0;
-  for (int k = 1; k <= b.NumRows(); k++) {
-    double s = 0.0;
-    for (int l = 1; l <= b.NumColumns(); l++) {
-      s += q(l, k) * y[l];
+void PathTracer::GivensDecomposition::Update(const Vector<double> &p_u,
+					     const Vector<double> &p_v)
+{
+  for (int i = 1; i <= m_q.NumRows(); i++) {
+    Matrix<double>::ConstRowView row = m_q.ViewRow(i);
+    m_work[i] = 0.0;
+    for (int j = 1; j <= m_q.NumColumns(); j++) {
+      m_work[i] += row[j] * p_u[j];
     }
-    u[k] -= s;
-    d += s * s;
   }
-  d = std::sqrt(d);
+  UpdateTriangular(m_r, m_work, p_v,
+		   [this](int p_row, double p_c, double p_s)
+		   { RotateRows(m_q, p_row, p_c, p_s, 1); });
 }
 
-}   // end anonymous namespace
+void PathTracer::GivensDecomposition::GetTangent(Vector<double> &p_tangent) const
+{
+  m_q.GetRow(m_q.NumRows(), p_tangent);
+}
 
+void PathTracer::GivensDecomposition::Solve(const Vector<double> &p_rhs,
+					    Vector<double> &p_solution) const
+{
+  int n = m_r.NumColumns();
+  for (int k = 1; k <= n; k++) {
+    m_work[k] = p_rhs[k];
+  }
+  SolveTransposed(m_r, m_work, n);
+
+  p_solution = 0.0;
+  for (int l = 1; l <= n; l++) {
+    Matrix<double>::ConstRowView row = m_q.ViewRow(l);
+    for (int k = 1; k <= m_q.NumColumns(); k++) {
+      p_solution[k] += row[k] * m_work[l];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//             PathTracer: Decomposition by Householder reflections
+//----------------------------------------------------------------------------
+
+void PathTracer::HouseholderDecomposition::Factor(const Matrix<double> &p_matrix)
+{
+  int m = p_matrix.NumRows(), n = p_matrix.NumColumns();
+  if (m_tau.Length() != n || m_work.Length() != m) {
+    m_rows = Array<int>(m);
+    m_cols = Array<int>(n);
+    m_norms = Array<double>(n);
+    m_fullNorms = Array<double>(n);
+    m_update = Array<double>(n);
+    m_tau = Array<double>(n);
+    m_work = Array<double>(m);
+    m_factors = Matrix<double>(m, n);
+    m_r = Matrix<double>(m, n);
+    m_z = Matrix<double>(m_blockSize, n);
+  }
+  m_rotations.clear();
+
+  Matrix<double> &a = m_factors;
+  a = p_matrix;
+  for (int i = 1; i <= m; i++) {
+    m_rows[i] = i;
+  }
+  for (int j = 1; j <= n; j++) {
+    m_cols[j] = j;
+    m_norms[j] = 0.0;
+  }
+  for (int i = 1; i <= m; i++) {
+    Matrix<double>::ConstRowView row = a.ViewRow(i);
+    for (int j = 1; j <= n; j++) {
+      m_norms[j] += sqr(row[j]);
+    }
+  }
+  for (int j = 1; j <= n; j++) {
+    m_fullNorms[j] = m_norms[j] = std::sqrt(m_norms[j]);
+  }
+  m_permutationSign = 1;
+
+  // Following Powell and Reid, each step takes the column of largest
+  // remaining norm, and the row with the largest entry in that column.
+  // The rows of a block of steps beyond the current step are only
+  // brought up to date when the block is finished: the reflections of
+  // the block, applied so far, subtract V Z from them, for V the
+  // reflection vectors and Z accumulated as each is computed (as in
+  // LAPACK's xLAQPS).  The row of each step, and the column it pivots
+  // on, are brought up to date as they are needed.
+  const double tolerance = std::sqrt(std::numeric_limits<double>::epsilon());
+  for (int k0 = 1; k0 <= n; k0 += m_blockSize) {
+    int k1 = std::min(k0 + m_blockSize - 1, n);
+
+    for (int k = k0; k <= k1; k++) {
+      int l = k - k0 + 1;
+
+      int pivot = k;
+      for (int j = k + 1; j <= n; j++) {
+	if (m_norms[j] > m_norms[pivot])  pivot = j;
+      }
+      if (pivot != k) {
+	a.SwitchColumns(k, pivot);
+	for (int q = 1; q < l; q++) {
+	  std::swap(m_z(q, k), m_z(q, pivot));
+	}
+	std::swap(m_norms[k], m_norms[pivot]);
+	std::swap(m_fullNorms[k], m_fullNorms[pivot]);
+	std::swap(m_cols[k], m_cols[pivot]);
+	m_permutationSign = -m_permutationSign;
+      }
+
+      pivot = k;
+      for (int i = k; i <= m; i++) {
+	Matrix<double>::RowView row = a.ViewRow(i);
+	for (int q = 1; q < l; q++) {
+	  row[k] -= row[k0 + q - 1] * m_z(q, k);
+	}
+	if (fabs(row[k]) > fabs(a(pivot, k)))  pivot = i;
+      }
+      if (pivot != k) {
+	a.SwitchRows(k, pivot);
+	std::swap(m_rows[k], m_rows[pivot]);
+	m_permutationSign = -m_permutationSign;
+      }
+
+      Matrix<double>::ColumnView column = a.ViewColumn(k);
+      double alpha = column[k], sigma = 0.0;
+      for (int i = k + 1; i <= m; i++) {
+	sigma += sqr(column[i]);
+      }
+      if (sigma == 0.0) {
+	m_tau[k] = 0.0;
+      }
+      else {
+	double beta = std::sqrt(sqr(alpha) + sigma);
+	if (alpha > 0.0)  beta = -beta;
+	m_tau[k] = (beta - alpha) / beta;
+	double scale = 1.0 / (alpha - beta);
+	for (int i = k + 1; i <= m; i++) {
+	  column[i] *= scale;
+	}
+	column[k] = beta;
+      }
+
+      // Row l of Z is tau v^T A for A the matrix with the reflections
+      // of the block before this one applied, and v the reflection
+      // vector, which is one in row k
+      Matrix<double>::RowView z = m_z.ViewRow(l);
+      for (int j = k + 1; j <= n; j++) {
+	z[j] = 0.0;
+      }
+      if (m_tau[k] != 0.0) {
+	for (int q = 1; q < l; q++) {
+	  m_work[q] = 0.0;
+	}
+	for (int i = k; i <= m; i++) {
+	  Matrix<double>::ConstRowView row = a.ViewRow(i);
+	  double vi = (i == k) ? 1.0 : row[k];
+	  for (int j = k + 1; j <= n; j++) {
+	    z[j] += vi * row[j];
+	  }
+	  for (int q = 1; q < l; q++) {
+	    m_work[q] += vi * row[k0 + q - 1];
+	  }
+	}
+	for (int q = 1; q < l; q++) {
+	  Matrix<double>::ConstRowView zq = m_z.ViewRow(q);
+	  for (int j = k + 1; j <= n; j++) {
+	    z[j] -= m_work[q] * zq[j];
+	  }
+	}
+	for (int j = k + 1; j <= n; j++) {
+	  z[j] *= m_tau[k];
+	}
+      }
+
+      // Bring row k up to date, and remove it from the remaining norms
+      // of the columns, computing them afresh when too much cancels
+      Matrix<double>::RowView row = a.ViewRow(k);
+      for (int q = 1; q <= l; q++) {
+	double vkq = (q == l) ? 1.0 : row[k0 + q - 1];
+	Matrix<double>::ConstRowView zq = m_z.ViewRow(q);
+	for (int j = k + 1; j <= n; j++) {
+	  row[j] -= vkq * zq[j];
+	}
+      }
+      for (int j = k + 1; j <= n; j++) {
+	if (m_norms[j] == 0.0)  continue;
+	double ratio = fabs(row[j]) / m_norms[j];
+	ratio = std::max(0.0, (1.0 + ratio) * (1.0 - ratio));
+	if (ratio * sqr(m_norms[j] / m_fullNorms[j]) > tolerance) {
+	  m_norms[j] *= std::sqrt(ratio);
+	  continue;
+	}
+	double norm = 0.0;
+	for (int i = k + 1; i <= m; i++) {
+	  Matrix<double>::ConstRowView rowi = a.ViewRow(i);
+	  double aij = rowi[j];
+	  for (int q = 1; q <= l; q++) {
+	    aij -= rowi[k0 + q - 1] * m_z(q, j);
+	  }
+	  norm += sqr(aij);
+	}
+	m_fullNorms[j] = m_norms[j] = std::sqrt(norm);
+      }
+    }
+
+    // Apply the block of reflections to the rows below it:
+    // A := A - V Z
+    for (int i = k1 + 1; i <= m; i++) {
+      Matrix<double>::RowView row = a.ViewRow(i);
+      for (int q = 1; q <= k1 - k0 + 1; q++) {
+	double viq = row[k0 + q - 1];
+	if (viq == 0.0)  continue;
+	Matrix<double>::ConstRowView zq = m_z.ViewRow(q);
+	for (int j = k1 + 1; j <= n; j++) {
+	  row[j] -= viq * zq[j];
+	}
+      }
+    }
+  }
+
+  m_r = 0.0;
+  for (int i = 1; i <= n; i++) {
+    Matrix<double>::ConstRowView src = a.ViewRow(i);
+    Matrix<double>::RowView dst = m_r.ViewRow(i);
+    for (int j = i; j <= n; j++) {
+      dst[j] = src[j];
+    }
+  }
+  SetOrientation();
+}
+
+void PathTracer::HouseholderDecomposition::Reflect(int p_col,
+						   Array<double> &p_x) const
+{
+  double tau = m_tau[p_col];
+  if (tau == 0.0)  return;
+  Matrix<double>::ConstColumnView column = m_factors.ViewColumn(p_col);
+  double d = p_x[p_col];
+  for (int i = p_col + 1; i <= m_factors.NumRows(); i++) {
+    d += column[i] * p_x[i];
+  }
+  d *= tau;
+  p_x[p_col] -= d;
+  for (int i = p_col + 1; i <= m_factors.NumRows(); i++) {
+    p_x[i] -= d * column[i];
+  }
+}
+
+void 
+PathTracer::HouseholderDecomposition::ApplyTranspose(Array<double> &p_x) const
+{
+  for (size_t r = m_rotations.size(); r > 0; r--) {
+    const Rotation &rot = m_rotations[r - 1];
+    double sv1 = p_x[rot.m_row], sv2 = p_x[rot.m_row + 1];
+    p_x[rot.m_row] = rot.m_c * sv1 - rot.m_s * sv2;
+    p_x[rot.m_row + 1] = rot.m_s * sv1 + rot.m_c * sv2;
+  }
+  for (int k = m_tau.Length(); k >= 1; k--) {
+    Reflect(k, p_x);
+  }
+}
+
+void PathTracer::HouseholderDecomposition::SetOrientation(void)
+{
+  // Q P B C = [R; 0] and Q P t = e_m, for P and C the permutations
+  // which sort the rows and columns, give
+  // det Q det P det C det [B t] = prod R_kk.  Each reflection has
+  // determinant -1 and each rotation +1.
+  m_sign = m_permutationSign;
+  for (int k = 1; k <= m_tau.Length(); k++) {
+    if (m_tau[k] != 0.0)  m_sign = -m_sign;
+    if (m_r(k, k) < 0.0)  m_sign = -m_sign;
+  }
+}
+
+void PathTracer::HouseholderDecomposition::Update(const Vector<double> &p_u,
+						  const Vector<double> &p_v)
+{
+  for (int i = 1; i <= p_u.Length(); i++) {
+    m_work[i] = p_u[m_rows[i]];
+  }
+  for (int k = 1; k <= m_tau.Length(); k++) {
+    Reflect(k, m_work);
+  }
+  for (size_t r = 0; r < m_rotations.size(); r++) {
+    const Rotation &rot = m_rotations[r];
+    double sv1 = m_work[rot.m_row], sv2 = m_work[rot.m_row + 1];
+    m_work[rot.m_row] = rot.m_c * sv1 + rot.m_s * sv2;
+    m_work[rot.m_row + 1] = -rot.m_s * sv1 + rot.m_c * sv2;
+  }
+
+  for (int k = 1; k <= p_v.Length(); k++) {
+    m_update[k] = p_v[m_cols[k]];
+  }
+  UpdateTriangular(m_r, m_work, m_update,
+		   [this](int p_row, double p_c, double p_s)
+		   { Rotation rot = { p_row, p_c, p_s };
+		     m_rotations.push_back(rot); });
+  SetOrientation();
+}
+
+void PathTracer::HouseholderDecomposition::Solve(const Vector<double> &p_rhs,
+						 Vector<double> &p_solution) const
+{
+  int n = m_r.NumColumns();
+  for (int k = 1; k <= n; k++) {
+    m_work[k] = p_rhs[m_cols[k]];
+  }
+  SolveTransposed(m_r, m_work, n);
+  m_work[n + 1] = 0.0;
+  ApplyTranspose(m_work);
+  for (int k = 1; k <= m_work.Length(); k++) {
+    p_solution[m_rows[k]] = m_work[k];
+  }
+}
+
+void PathTracer::HouseholderDecomposition::GetTangent(Vector<double> &p_tangent) const
+{
+  for (int k = 1; k < m_work.Length(); k++) {
+    m_work[k] = 0.0;
+  }
+  m_work[m_work.Length()] = 1.0;
+  ApplyTranspose(m_work);
+  for (int k = 1; k <= m_work.Length(); k++) {
+    p_tangent[m_rows[k]] = m_sign * m_work[k];
+  }
+}
 
 //----------------------------------------------------------------------------
 //             PathTracer: Implementation of path-following engine
@@ -135,13 +521,15 @@ PathTracer::TracePath(const EquationSystem &p_system,
   // t is current tangent at x; newT is tangent at u, which is the next point.
   Vector<double> t(x.Length()), newT(x.Length());
   Vector<double> y(x.Length() - 1);
+  // s is the Newton correction, which is subtracted from u
+  Vector<double> s(x.Length()), du(x.Length());
   Matrix<double> b(x.Length(), x.Length() - 1);
-  SquareMatrix<double> q(x.Length());
+  shared_ptr<Decomposition> qr(m_decomposition->Copy());
 
   p_callback(x, false);
   p_system.GetJacobian(x, b);
-  QRDecomp(b, q);
-  q.GetRow(q.NumRows(), t);
+  qr->Factor(b);
+  qr->GetTangent(t);
   
   while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda) {
     bool accept = true;
@@ -161,7 +549,7 @@ PathTracer::TracePath(const EquationSystem &p_system,
 
     double decel = 1.0 / m_maxDecel;  // initialize deceleration factor
     p_system.GetJacobian(u, b);
-    QRDecomp(b, q);
+    qr->Factor(b);
 
     int iter = 1;
     double disto = 0.0;
@@ -169,7 +557,21 @@ PathTracer::TracePath(const EquationSystem &p_system,
       double dist;
 
       p_system.GetValue(u, y);
-      NewtonStep(q, b, u, y, dist); 
+      if (m_broyden && iter >= 2) {
+	// Broyden's update B := B + du y^T / |du|^2 for the last step
+	// du = -s, which makes the Jacobian satisfy the secant condition
+	// on that step.  Since B^T du = -y at the last point, the
+	// correction term is just the value y at the new point.
+	du = s * (-1.0 / (s * s));
+	qr->Update(du, y);
+      }
+      qr->Solve(y, s);
+      dist = 0.0;
+      for (int k = 1; k <= u.Length(); k++) {
+	u[k] -= s[k];
+	dist += s[k] * s[k];
+      }
+      dist = std::sqrt(dist);
 
       if (dist >= c_maxDist) {
 	accept = false;
@@ -222,7 +624,7 @@ PathTracer::TracePath(const EquationSystem &p_system,
     }
 
     // Obtain the tangent at the next step
-    q.GetRow(q.NumRows(), newT); 
+    qr->GetTangent(newT);
 
     // If we are at a bifurcation point, the orientation of the tangent
     // will flip.  This will confuse many criterion functions, especially
@@ -23,6 +23,8 @@
 #ifndef PATH_H
 #define PATH_H
 
+#include <vector>
+
 namespace Gambit {
 
 //
@@ -88,14 +90,132 @@ public:
   };
   
 
+  //
+  // Encapsulates the dense linear algebra done at each step: an orthogonal
+  // decomposition Q B = [R; 0] of the transpose B of the Jacobian, which
+  // has one more row than it has columns.  The tangent to the path and
+  // the Newton corrections are computed from the decomposition.
+  //
+  class Decomposition {
+  public:
+    virtual ~Decomposition() { }
+    virtual Decomposition *Copy(void) const = 0;
+
+    // Decompose the transpose of the Jacobian.
+    virtual void Factor(const Matrix<double> &p_matrix) = 0;
+    // Update the decomposition to that of B + u v^T.
+    virtual void Update(const Vector<double> &p_u,
+			const Vector<double> &p_v) = 0;
+    // Compute the unit tangent to the path, the last row of Q.
+    virtual void GetTangent(Vector<double> &p_tangent) const = 0;
+    // Compute the solution s of least norm to B^T s = y.
+    virtual void Solve(const Vector<double> &p_rhs,
+		       Vector<double> &p_solution) const = 0;
+  };
+
+  //
+  // The decomposition by Givens rotations, with Q formed explicitly.
+  //
+  class GivensDecomposition : public Decomposition {
+  public:
+    virtual ~GivensDecomposition() { }
+    virtual Decomposition *Copy(void) const
+    { return new GivensDecomposition(*this); }
+
+    virtual void Factor(const Matrix<double> &p_matrix);
+    virtual void Update(const Vector<double> &p_u, const Vector<double> &p_v);
+    virtual void GetTangent(Vector<double> &p_tangent) const;
+    virtual void Solve(const Vector<double> &p_rhs,
+		       Vector<double> &p_solution) const;
+
+  private:
+    Matrix<double> m_r, m_q;
+    mutable Array<double> m_work;
+  };
+
+  //
+  // The decomposition by Householder reflections, computed a block of
+  // columns at a time so that most of the work is done by updates of
+  // whole rows.  Q is kept in factored form, as the reflections followed
+  // by the Givens rotations of any updates.
+  //
+  // Unlike Givens rotations, Householder reflections are only accurate
+  // for matrices whose rows differ widely in scale, as the Jacobian does
+  // when some probabilities are near zero, if the rows and the columns
+  // are pivoted as by Powell and Reid: each step reflects the column of
+  // largest remaining norm, about its entry of largest magnitude.
+  //
+  class HouseholderDecomposition : public Decomposition {
+  public:
+    HouseholderDecomposition(int p_blockSize = 32)
+      : m_blockSize(p_blockSize), m_permutationSign(1), m_sign(1) { }
+    virtual ~HouseholderDecomposition() { }
+    virtual Decomposition *Copy(void) const
+    { return new HouseholderDecomposition(*this); }
+
+    virtual void Factor(const Matrix<double> &p_matrix);
+    virtual void Update(const Vector<double> &p_u, const Vector<double> &p_v);
+    virtual void GetTangent(Vector<double> &p_tangent) const;
+    virtual void Solve(const Vector<double> &p_rhs,
+		       Vector<double> &p_solution) const;
+
+  private:
+    class Rotation {
+    public:
+      int m_row;
+      double m_c, m_s;
+    };
+
+    int m_blockSize;
+    // The rows and columns of the matrix, in the order they were factored
+    Array<int> m_rows, m_cols;
+    // The norms of the columns below the rows factored so far, and as
+    // last computed directly
+    Array<double> m_norms, m_fullNorms;
+    // The product of the signs of the permutations m_rows and m_cols
+    int m_permutationSign;
+    // The reflection vectors, below the diagonal
+    Matrix<double> m_factors;
+    Array<double> m_tau;
+    Matrix<double> m_r;
+    std::vector<Rotation> m_rotations;
+    // The sign which orients the tangent so det [B t] > 0
+    int m_sign;
+    mutable Array<double> m_work;
+    Array<double> m_update;
+    // The accumulated reflections of the current block, applied to the
+    // columns after it
+    Matrix<double> m_z;
+
+    // Applies the reflection computed from column p_col to p_x
+    void Reflect(int p_col, Array<double> &p_x) const;
+    // Applies Q^T to p_x
+    void ApplyTranspose(Array<double> &p_x) const;
+    void SetOrientation(void);
+  };
+
   void SetMaxDecel(double p_maxDecel) { m_maxDecel = p_maxDecel; }
   double GetMaxDecel(void) const { return m_maxDecel; }
 
   void SetStepsize(double p_hStart) { m_hStart = p_hStart; }
   double GetStepsize(void) const { return m_hStart; }
 
+  // Sets the decomposition used at each step (by default, Householder).
+  void SetDecomposition(const Decomposition &p_decomposition)
+  { m_decomposition = p_decomposition.Copy(); }
+  const Decomposition &GetDecomposition(void) const
+  { return *m_decomposition; }
+
+  // If set, the corrector updates the decomposition by Broyden's
+  // method after each Newton step, rather than using the one computed
+  // from the Jacobian at the predicted point throughout.
+  void SetBroydenUpdates(bool p_updates) { m_broyden = p_updates; }
+  bool GetBroydenUpdates(void) const { return m_broyden; }
+
 protected:
-  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03)
+  PathTracer(void)
+    : m_maxDecel(1.1), m_hStart(0.03), m_broyden(false),
+      m_decomposition(new HouseholderDecomposition)
     { } 
   virtual ~PathTracer() { }
 
@@ -106,6 +226,8 @@ protected:
 
 private:
   double m_maxDecel, m_hStart;
+  bool m_broyden;
+  shared_ptr<Decomposition> m_decomposition;
 };
 
 }  // end namespace Gambit
@@ -28,6 +28,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "efglp.h"
 #include "nfglp.h"
 
@@ -127,6 +128,10 @@ int main(int argc, char *argv[])
 
   try {
     Gambit::Game game = Gambit::ReadGame(*input_stream);
+    if (game->IsTree() && useStrategic) {
+      dynamic_cast<Gambit::GameTreeRep &>(*game).SetPayoffTableLimit(
+	Gambit::GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
     if (!game->IsTree() || useStrategic) {
       if (useFloat) {
 	shared_ptr<StrategyProfileRenderer<double> > renderer;
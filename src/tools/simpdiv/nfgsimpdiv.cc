@@ -28,8 +28,10 @@
 #include <iomanip>
 #include <fstream>
 #include "gambit/gambit.h"
+#include "gambit/gametree.h"
 #include "gambit/nash.h"
 #include "gambit/nash/simpdiv.h"
+#include "gambit/nash/multistart.h"
 
 using namespace Gambit;
 using namespace Gambit::Nash;
@@ -70,6 +72,33 @@ RandomProfiles(const Game &p_game, int p_count, const Rational &denom)
   return profiles;
 }
 
+class SimpdivStarts
+  : public MultiStartSolver<MixedStrategyProfile<Rational>,
+			    MixedStrategyProfile<Rational> > {
+public:
+  SimpdivStarts(int p_gridResize, bool p_verbose,
+		int p_numThreads, int p_stopAfter)
+    : MultiStartSolver<MixedStrategyProfile<Rational>,
+		       MixedStrategyProfile<Rational> >(p_numThreads, p_stopAfter),
+      m_gridResize(p_gridResize), m_verbose(p_verbose)
+  { }
+  virtual ~SimpdivStarts() { }
+
+  virtual List<MixedStrategyProfile<Rational> > 
+  SolveStart(const MixedStrategyProfile<Rational> &p_start,
+	     std::ostream &p_stream) const
+  {
+    shared_ptr<StrategyProfileRenderer<Rational> > renderer;
+    renderer = new MixedStrategyCSVRenderer<Rational>(p_stream);
+    NashSimpdivStrategySolver algorithm(m_gridResize, 0, m_verbose,
+					renderer);
+    return algorithm.Solve(p_start);
+  }
+
+private:
+  int m_gridResize;
+  bool m_verbose;
+};
 
 void PrintBanner(std::ostream &p_stream)
 {
@@ -92,6 +121,8 @@ void PrintHelp(char *progname)
   std::cerr << "  -r DENOM         generate random starting points with denominator DENOM\n";
   std::cerr << "  -n COUNT         number of starting points to generate (requires -r)\n";
   std::cerr << "  -s FILE          file containing starting points\n";
+  std::cerr << "  -j THREADS       solve from THREADS starting points at once\n";
+  std::cerr << "  -e EQA           terminate after finding EQA distinct equilibria\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -105,6 +136,7 @@ int main(int argc, char *argv[])
   std::string startFile;
   bool useRandom = false;
   int randDenom = 1, gridResize = 2, stopAfter = 1;
+  int numThreads = 1, numEquilibria = 0;
   bool verbose = false, quiet = false;
 
   int long_opt_index = 0;
@@ -115,7 +147,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "g:hVvn:r:s:d:qS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "g:hVvn:r:s:d:j:e:qS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -135,6 +167,12 @@ int main(int argc, char *argv[])
     case 's':
       startFile = optarg;
       break;
+    case 'j':
+      numThreads = atoi(optarg);
+      break;
+    case 'e':
+      numEquilibria = atoi(optarg);
+      break;
     case 'q':
       quiet = true;
       break;
@@ -175,6 +213,14 @@ int main(int argc, char *argv[])
 
   try {
     Game game = ReadGame(*input_stream);
+    if (game->IsTree()) {
+      dynamic_cast<GameTreeRep &>(*game).SetPayoffTableLimit(
+	GameTreeRep::DEFAULT_PAYOFF_TABLE_LIMIT);
+    }
+    if (game->IsAgg() || game->IsBagg()) {
+      // Evaluating profiles on action graph games is not thread-safe
+      numThreads = 1;
+    }
     List<MixedStrategyProfile<Rational> > starts;
     if (startFile != "") {
       std::ifstream startPoints(startFile.c_str());
@@ -190,13 +236,8 @@ int main(int argc, char *argv[])
 	starts[1][game->Players()[pl]->Strategies()[1]] = Rational(1);
       }
     }
-    for (int i = 1; i <= starts.size(); i++) {
-      shared_ptr<StrategyProfileRenderer<Rational> > renderer;
-      renderer = new MixedStrategyCSVRenderer<Rational>(std::cout);
-      NashSimpdivStrategySolver algorithm(gridResize, 0, verbose,
-					  renderer);
-      algorithm.Solve(starts[i]);
-    }
+    SimpdivStarts algorithm(gridResize, verbose, numThreads, numEquilibria);
+    algorithm.Solve(starts, std::cout);
     return 0;
   }
   catch (std::runtime_error &e) {